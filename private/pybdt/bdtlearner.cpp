@@ -1,19 +1,23 @@
 // bdtlearner.cpp
 
-#include <Python.h>
-
 #include "bdtlearner.hpp"
+#include "gbmodel.hpp"
 #include "np.hpp"
 
 #include "notifier.hpp"
+#include "parallel.hpp"
 
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/pointer_cast.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
 
 using namespace std;
 using namespace boost;
-namespace py = boost::python;
 
 
 BDTLearner::BDTLearner (const vector<string>& feature_names,
@@ -32,28 +36,13 @@ BDTLearner::BDTLearner (const vector<string>& feature_names,
 }
 
 
-BDTLearner::BDTLearner (const py::list& feature_names,
-                        const string& weight_name)
-: Learner (feature_names, weight_name)
-{
-    set_defaults ();
-}
-
-BDTLearner::BDTLearner (const py::list& feature_names,
-                        const string& sig_weight_name,
-                        const string& bg_weight_name)
-: Learner (feature_names, sig_weight_name, bg_weight_name)
-{
-    set_defaults ();
-}
-
-
 BDTLearner::~BDTLearner ()
 {
 }
 
 //TODO: Class Booster needs to be implemented...
-Booster::Booster(bool init_bool, double nsig=0, double nbg=0){
+Booster::Booster(bool init_bool, double nsig=0, double nbg=0)
+  : quant_val(0.7), p(0), sketch_threshold(0){
   init_bool ? InitFX(nsig,nbg) : InitFX(-9999,-9999,false); 
 }
 
@@ -79,33 +68,169 @@ void Booster::InitFX(double n_sig,double n_bg, bool useInit){
     }
 }
     
-//TODO: Add GetQuantile to Booster class
-double GetQuantile(vecpdd rw_vpair, double quant_val, bool weighted=false, double weightSum = 0){
-//Hold sum of all weights, current sum of weights, and final output quantile
-  double allWeights = 0;
-  double sumWeight = 0;
-  double res_quant = 0;
-//Set sum of weights depending on if it is weighted quantile or not 
-  weighted ? allWeights = weightSum : allWeights = rw_vpair.size();
-//Sort residuals
-  sort(rw_vpair.begin(),rw_vpair.end()); 
-//Loop over sorted residuals and get quantile
-  for(vecpdd_iter rw_pair=rw_vpair.begin();
-      rw_pair!=rw_vpair.end(); rw_pair++){
-    double weight = 0;
-//Set weight based on if it is a weighted quantile or not
-    weighted ? weight=rw_pair->second : weight=1; 
-//Loop until it reaches quantile
-    if(sumWeight<quant_val*allWeights){
-      res_quant = rw_pair->first;
-      sumWeight+=weight; 
+void Booster::InitEvents(const vector<double>& sig_weights,
+                         const vector<double>& bg_weights){
+  const size_t n_sig(sig_weights.size());
+  const size_t n_events(n_sig+bg_weights.size());
+  F.assign(n_events,f_mmone);
+  y.assign(n_events,-1);
+  fill(y.begin(),y.begin()+n_sig,1);
+  w=sig_weights;
+  w.insert(w.end(),bg_weights.begin(),bg_weights.end());
+}
+
+void Booster::TraceLeaves(DTNode& root, const vector<Event>& sig,
+                          const vector<Event>& bg){
+//Flatten the tree once, numbering the leaves left to right, so that each
+//event is traced through the flat array straight to its leaf id
+  leaves.clear();
+  nodes.assign(1,FlatNode());
+  vector<pair<DTNode*,int> > stack(1,make_pair(&root,0));
+  while(!stack.empty()){
+    DTNode* node=stack.back().first;
+    const int k=stack.back().second;
+    stack.pop_back();
+    if(node->is_leaf()){
+      nodes[k].left=-1;
+      nodes[k].leaf=leaves.size();
+      leaves.push_back(node);
+    }
+    else{
+      const int left=nodes.size();
+      nodes.resize(left+2);
+      nodes[k].feature=node->feature_id();
+      nodes[k].value=node->feature_val();
+      nodes[k].left=left;
+      stack.push_back(make_pair(node->right().get(),left+1));
+      stack.push_back(make_pair(node->left().get(),left));
+    }
+  }
+  leaf.resize(sig.size()+bg.size());
+  vector<int>::iterator i_leaf=leaf.begin();
+  for(vector<Event>::const_iterator i_ev=sig.begin();
+      i_ev!=sig.end(); ++i_ev, ++i_leaf){
+    *i_leaf=TraceLeaf(*i_ev);
+  }
+  for(vector<Event>::const_iterator i_ev=bg.begin();
+      i_ev!=bg.end(); ++i_ev, ++i_leaf){
+    *i_leaf=TraceLeaf(*i_ev);
+  }
+}
+
+int Booster::TraceLeaf(const Event& e) const{
+//Same rule as DTNode::trace: below the cut goes left
+  int k=0;
+  while(nodes[k].left>=0){
+    const FlatNode& node=nodes[k];
+    k=e[node.feature]<node.value ? node.left : node.left+1;
+  }
+  return nodes[k].leaf;
+}
+
+void Booster::AddTree(DTNode& root, const vector<Event>& sig,
+                      const vector<Event>& bg){
+  TraceLeaves(root,sig,bg);
+  for(size_t i=0; i<F.size(); ++i){
+    F[i]+=leaves[leaf[i]]->response();
+  }
+}
+
+void Booster::Boost(DTNode& root, const vector<Event>& sig,
+                    const vector<Event>& bg){
+  TraceLeaves(root,sig,bg);
+  const size_t n_events(F.size());
+  const size_t n_leaves(leaves.size());
+//delta: quant_val quantile of the absolute residuals
+  pairs.resize(n_events);
+  double weightSum=0;
+  for(size_t i=0; i<n_events; ++i){
+    pairs[i]=make_pair(fabs(y[i]-F[i]),w[i]);
+    weightSum+=w[i];
+  }
+  const double delta=Quantile(pairs.begin(),pairs.end(),quant_val,weightSum);
+//Group the residuals by leaf (counting sort), so each leaf is a slice
+  vector<size_t> offsets(n_leaves+1,0);
+  vector<double> leafWeights(n_leaves,0);
+  for(size_t i=0; i<n_events; ++i){
+    ++offsets[leaf[i]+1];
+    leafWeights[leaf[i]]+=w[i];
+  }
+  for(size_t j=0; j<n_leaves; ++j){
+    offsets[j+1]+=offsets[j];
+  }
+  vector<size_t> next(offsets.begin(),offsets.end()-1);
+  for(size_t i=0; i<n_events; ++i){
+    pairs[next[leaf[i]]++]=make_pair(y[i]-F[i],w[i]);
+  }
+//Leaf value: median residual plus the mean clipped deviation from it
+  vector<double> gamma(n_leaves,0);
+  for(size_t j=0; j<n_leaves; ++j){
+    const vecpdd_iter first=pairs.begin()+offsets[j];
+    const vecpdd_iter last=pairs.begin()+offsets[j+1];
+    if(first==last || !(leafWeights[j]>0)){
+      continue;
+    }
+    const double r_bar=Quantile(first,last,0.5,leafWeights[j]);
+    double gamma_j=0;
+    for(vecpdd_iter pair_i=first; pair_i!=last; ++pair_i){
+      const double meddiff_i=pair_i->first-r_bar;
+      gamma_j+=pair_i->second*boost::math::sign(meddiff_i)
+        *std::min(delta,fabs(meddiff_i));
+    }
+    gamma[j]=r_bar+gamma_j/leafWeights[j];
+    leaves[j]->response(gamma[j]);
+  }
+  for(size_t i=0; i<n_events; ++i){
+    F[i]+=gamma[leaf[i]];
+  }
+}
+
+void Booster::LogisticGradients(vector<double>& sig_g, vector<double>& sig_h,
+                                vector<double>& bg_g,
+                                vector<double>& bg_h) const{
+//With P(signal)=1/(1+exp(-F)): g=w*(P-[signal]), h=w*P*(1-P)
+  const size_t n_sig(count(y.begin(),y.end(),1.));
+  sig_g.resize(n_sig);
+  sig_h.resize(n_sig);
+  bg_g.resize(F.size()-n_sig);
+  bg_h.resize(F.size()-n_sig);
+  for(size_t i=0; i<F.size(); ++i){
+    const double prob=1/(1+exp(-F[i]));
+    const double g=w[i]*(prob-(y[i]>0 ? 1 : 0));
+    const double h=w[i]*std::max(prob*(1-prob),1e-16);
+    if(i<n_sig){
+      sig_g[i]=g;
+      sig_h[i]=h;
     }
     else{
-      break;
+      bg_g[i-n_sig]=g;
+      bg_h[i-n_sig]=h;
     }
   }
-//Return quantile
-  return res_quant;
+}
+
+double Booster::LogisticLoss() const{
+  double loss=0;
+  double weightSum=0;
+  for(size_t i=0; i<F.size(); ++i){
+    const double margin=y[i]*F[i];
+//log(1+exp(-margin)), without overflow for large |margin|
+    loss+=w[i]*(margin>0 ? log1p(exp(-margin)) : log1p(exp(margin))-margin);
+    weightSum+=w[i];
+  }
+  return weightSum>0 ? loss/weightSum : 0;
+}
+
+double Booster::Quantile(vecpdd_iter first, vecpdd_iter last,
+                         double quant_val, double weightSum) const{
+  if(sketch_threshold>0 && last-first>sketch_threshold){
+    QuantileSketch sketch;
+    for(vecpdd_iter rw_pair=first; rw_pair!=last; rw_pair++){
+      sketch.add(rw_pair->first,rw_pair->second);
+    }
+    return sketch.quantile(quant_val,weightSum);
+  }
+  return weighted_quantile(first,last,quant_val,true,weightSum);
 }
 
 
@@ -125,6 +250,39 @@ BDTLearner::beta (double beta) {
     m_beta = beta; 
 }
 
+string
+BDTLearner::boost_type () const {
+    return m_boost_type;
+}
+
+void
+BDTLearner::boost_type (const string& type) {
+    if (type != "adaboost" and type != "newton") {
+        throw std::runtime_error ("unknown boost type \"" + type + "\"");
+    }
+    m_boost_type = type;
+}
+
+string
+BDTLearner::checkpoint_filename () const {
+    return m_checkpoint_filename;
+}
+
+void
+BDTLearner::checkpoint_filename (const string& filename) {
+    m_checkpoint_filename = filename;
+}
+
+int
+BDTLearner::checkpoint_interval () const {
+    return m_checkpoint_interval;
+}
+
+void
+BDTLearner::checkpoint_interval (int n) {
+    m_checkpoint_interval = n;
+}
+
 double
 BDTLearner::frac_random_events () const {
     return m_frac_random_events; 
@@ -135,6 +293,46 @@ BDTLearner::frac_random_events (double n) {
     m_frac_random_events = n; 
 }
 
+double
+BDTLearner::goss_rest () const {
+    return m_goss_rest;
+}
+
+void
+BDTLearner::goss_rest (double frac) {
+    m_goss_rest = frac;
+}
+
+double
+BDTLearner::goss_top () const {
+    return m_goss_top;
+}
+
+void
+BDTLearner::goss_top (double frac) {
+    m_goss_top = frac;
+}
+
+double
+BDTLearner::l2 () const {
+    return m_l2;
+}
+
+void
+BDTLearner::l2 (double l2) {
+    m_l2 = l2;
+}
+
+double
+BDTLearner::learning_rate () const {
+    return m_learning_rate;
+}
+
+void
+BDTLearner::learning_rate (double rate) {
+    m_learning_rate = rate;
+}
+
 int
 BDTLearner::num_trees () const {
     return m_num_trees;
@@ -150,22 +348,105 @@ BDTLearner::quiet () const {
     return m_quiet;
 }
 
+int
+BDTLearner::quantile_sketch_threshold () const {
+    return m_quantile_sketch_threshold;
+}
+
+void
+BDTLearner::quantile_sketch_threshold (int n) {
+    m_quantile_sketch_threshold = n;
+}
+
+string
+BDTLearner::sampling () const {
+    return m_sampling;
+}
+
+void
+BDTLearner::sampling (const string& sampling) {
+    check_sampling (sampling);
+    m_sampling = sampling;
+}
+
+void
+BDTLearner::check_sampling (const string& sampling)
+{
+    if (sampling != "uniform" and sampling != "weighted"
+        and sampling != "goss") {
+        throw std::runtime_error ("unknown sampling \"" + sampling + "\"");
+    }
+}
+
 void
 BDTLearner::quiet (bool val) {
     m_quiet = val;
 }
 
 
-py::list
+BDTConfig
+BDTLearner::config () const
+{
+    BDTConfig out;
+    out.dtlearner = m_dtlearner;
+    out.dt = m_dtlearner->config ();
+    out.seed = m_dtlearner->seed ();
+    out.boost_type = m_boost_type;
+    out.beta = m_beta;
+    out.checkpoint_filename = m_checkpoint_filename;
+    out.checkpoint_interval = m_checkpoint_interval;
+    out.frac_random_events = m_frac_random_events;
+    out.goss_rest = m_goss_rest;
+    out.goss_top = m_goss_top;
+    out.learning_rate = m_learning_rate;
+    out.l2 = m_l2;
+    out.num_trees = m_num_trees;
+    out.quantile_sketch_threshold = m_quantile_sketch_threshold;
+    out.quiet = m_quiet;
+    out.sampling = m_sampling;
+    out.log = m_log;
+    out.before_pruners = m_before_pruners;
+    out.after_pruners = m_after_pruners;
+    return out;
+}
+
+boost::shared_ptr<TrainingLog>
+BDTLearner::training_log () const
+{
+    return m_log;
+}
+
+// profiling covers the trees as well as the boosting, so the profile
+// lives in the DTLearner
+
+boost::shared_ptr<TrainingProfile>
+BDTLearner::profile () const
+{
+    return m_dtlearner->profile ();
+}
+
+bool
+BDTLearner::profiling () const
+{
+    return m_dtlearner->profiling ();
+}
+
+void
+BDTLearner::profiling (bool value)
+{
+    m_dtlearner->profiling (value);
+}
+
+vector<boost::shared_ptr<Pruner> >
 BDTLearner::after_pruners () const
 {
-    return np::vector_to_list (m_after_pruners);
+    return m_after_pruners;
 }
 
-py::list
+vector<boost::shared_ptr<Pruner> >
 BDTLearner::before_pruners () const
 {
-    return np::vector_to_list (m_before_pruners);
+    return m_before_pruners;
 }
 
 void
@@ -202,9 +483,22 @@ BDTLearner::set_defaults ()
     //    m_feature_names, m_sig_weight_name, m_bg_weight_name);
 
     m_beta = 1;
+    m_boost_type = "adaboost";
+    m_checkpoint_filename = "";
+    m_checkpoint_interval = 0;
     m_frac_random_events = 1.;
+    m_goss_rest = 0.1;
+    m_goss_top = 0.2;
+    m_l2 = 1.;
+    m_learning_rate = 0.1;
     m_num_trees = 300;
+    m_quantile_sketch_threshold = 0;
     m_quiet = false;
+    m_sampling = "uniform";
+    // the log is kept, so that Python references to it stay connected
+    if (not m_log) {
+        m_log = boost::make_shared<TrainingLog> ();
+    }
 
     clear_after_pruners ();
     clear_before_pruners ();
@@ -213,9 +507,247 @@ BDTLearner::set_defaults ()
 
 boost::shared_ptr<Model>
 BDTLearner::train_given_everything (
+    const vector<Event>& sig, const vector<Event>& bg,
+    const vector<double>& init_sig_weights,
+    const vector<double>& init_bg_weights,
+    TrainingStatus* status) const
+{
+    return train_given_config (
+        config (), sig, bg, init_sig_weights, init_bg_weights, 0, status);
+}
+
+namespace {
+
+// for trainings run side by side: no progress output, no checkpoints
+void
+make_quiet (BDTConfig& config)
+{
+    config.quiet = true;
+    config.checkpoint_filename = "";
+    config.checkpoint_interval = 0;
+}
+
+// trains configs[i] for parallel::parallel_for
+struct GridTrainer {
+    GridTrainer (const BDTLearner& learner,
+                 const vector<BDTConfig>& configs,
+                 const TrainingSample& sample,
+                 vector<boost::shared_ptr<Model> >& models)
+        : learner (learner), configs (configs), sample (sample),
+        models (models)
+    { }
+
+    void operator() (int i)
+    {
+        models[i] = learner.train_given_config (
+            configs[i], sample.sig_events (), sample.bg_events (),
+            sample.sig_weights (), sample.bg_weights ());
+    }
+
+    const BDTLearner& learner;
+    const vector<BDTConfig>& configs;
+    const TrainingSample& sample;
+    vector<boost::shared_ptr<Model> >& models;
+};
+
+}
+
+vector<boost::shared_ptr<Model> >
+BDTLearner::train_grid (const DataSet& sig, const DataSet& bg,
+                        const vector<BDTConfig>& configs,
+                        int num_threads) const
+{
+    start_training ();
+    // projection and NaN filtering are done once; every training only
+    // reads the shared sample
+    const TrainingSample sample (
+        sig, bg, m_feature_names,
+        initial_weights (sig, m_sig_weight_name),
+        initial_weights (bg, m_bg_weight_name));
+    // the grid members run side by side, so none of them may print
+    // progress or write the (one) checkpoint file
+    vector<BDTConfig> grid (configs);
+    for (size_t i (0); i < grid.size (); ++i) {
+        make_quiet (grid[i]);
+        if (grid[i].run.empty ()) {
+            ostringstream run;
+            run << "grid " << i;
+            grid[i].run = run.str ();
+        }
+    }
+    vector<boost::shared_ptr<Model> > models (grid.size ());
+    GridTrainer trainer (*this, grid, sample, models);
+    parallel::parallel_for (grid.size (), num_threads, trainer);
+    return models;
+}
+
+void
+BDTLearner::start_training () const
+{
+    m_log->clear ();
+}
+
+boost::shared_ptr<Model>
+BDTLearner::train_quietly (const vector<Event>& sig, const vector<Event>& bg,
+                           const vector<double>& init_sig_weights,
+                           const vector<double>& init_bg_weights,
+                           const string& run,
+                           TrainingStatus* status) const
+{
+    BDTConfig quiet_config (config ());
+    make_quiet (quiet_config);
+    quiet_config.run = run;
+    return train_given_config (
+        quiet_config, sig, bg, init_sig_weights, init_bg_weights, 0, status);
+}
+
+boost::shared_ptr<Model>
+BDTLearner::resume (const DataSet& sig, const DataSet& bg,
+                    TrainingStatus* status) const
+{
+    const BDTConfig this_config (config ());
+    const string& filename (this_config.checkpoint_filename);
+    if (filename.empty ()) {
+        throw std::runtime_error ("no checkpoint_filename set");
+    }
+    start_training ();
+    BDTCheckpoint checkpoint;
+    checkpoint.load (filename);
+    if (checkpoint.feature_names != m_feature_names) {
+        throw std::runtime_error (
+            "checkpoint \"" + filename
+            + "\" was written for different features");
+    }
+    const TrainingSample sample (
+        sig, bg, m_feature_names,
+        initial_weights (sig, m_sig_weight_name),
+        initial_weights (bg, m_bg_weight_name));
+    if (checkpoint.sig_weights.size () != sample.sig_events ().size ()
+        or checkpoint.bg_weights.size () != sample.bg_events ().size ()) {
+        throw std::runtime_error (
+            "checkpoint \"" + filename
+            + "\" was written for different events");
+    }
+    return train_given_config (
+        this_config, sample.sig_events (), sample.bg_events (),
+        sample.sig_weights (), sample.bg_weights (), &checkpoint, status);
+}
+
+namespace {
+
+typedef boost::posix_time::ptime ptime;
+
+ptime
+now ()
+{
+    return boost::posix_time::microsec_clock::universal_time ();
+}
+
+// pass the summary of tree m to config.log
+void
+log_tree (const BDTConfig& config, int m, double error, double alpha,
+          DTModel& dtmodel, const ptime& start)
+{
+    if (not config.log) {
+        return;
+    }
+    TreeRecord record;
+    record.run = config.run;
+    record.tree = m;
+    record.num_trees = config.num_trees;
+    record.error = error;
+    record.alpha = alpha;
+    record.n_leaves = dtmodel.root ()->n_leaves ();
+    record.max_depth = dtmodel.root ()->max_depth ();
+    record.seconds = (now () - start).total_microseconds () / 1e6;
+    config.log->tree (record);
+}
+
+// n events drawn with probability proportional to weight; each pick
+// carries an equal share of the total weight, so weighted sums over the
+// picks are unbiased estimates of those over all events
+void
+weighted_subsample (RandomSampler& sampler, int n,
+                    const vector<Event>& events, const vector<double>& weights,
+                    vector<Event>& picked_events,
+                    vector<double>& picked_weights)
+{
+    if (n <= 0) {
+        return;
+    }
+    vector<int> indices;
+    sampler.sample_weighted (n, weights, indices);
+    picked_events = np::subscript (events, indices);
+    picked_weights.assign (n, np::sum (weights) / n);
+}
+
+// orders indices by decreasing magnitude of the values they point to
+struct LargerMagnitude {
+    explicit LargerMagnitude (const vector<double>& values)
+        : values (values)
+    {}
+    bool operator() (int i, int j) const
+    {
+        return fabs (values[i]) > fabs (values[j]);
+    }
+    const vector<double>& values;
+};
+
+// Gradient-based one-side sampling: the top fraction of indices by
+// |magnitudes| are all kept, with factor 1, and a rest fraction of all
+// indices is drawn from the others without replacement, with a factor
+// that scales them up to stand in for every index not in the top
+void
+goss_indices (RandomSampler& sampler, double top, double rest,
+              const vector<double>& magnitudes,
+              vector<int>& indices, vector<double>& factors)
+{
+    if (top < 0 or rest <= 0 or top + rest > 1) {
+        throw std::runtime_error (
+            "goss_top and goss_rest must satisfy 0 <= goss_top, "
+            "0 < goss_rest and goss_top + goss_rest <= 1");
+    }
+    const int n (magnitudes.size ());
+    const int n_top (static_cast<int> (top * n));
+    const int n_others (n - n_top);
+    const int n_rest (min (max (static_cast<int> (rest * n), 1), n_others));
+    vector<int> order (np::range<int> (0, n));
+    if (n_top > 0 and n_others > 0) {
+        nth_element (order.begin (), order.begin () + n_top, order.end (),
+                     LargerMagnitude (magnitudes));
+    }
+    indices.assign (order.begin (), order.begin () + n_top);
+    factors.assign (n_top, 1.);
+    vector<int> picks;
+    sampler.sample_indices (n_rest, n_others, false, picks);
+    for (int i (0); i < n_rest; ++i) {
+        indices.push_back (order[n_top + picks[i]]);
+    }
+    factors.resize (n_top + n_rest, n_rest ? 1. * n_others / n_rest : 1.);
+}
+
+// report where a resumed training picks up
+void
+log_resume (const BDTConfig& config, int first_tree)
+{
+    if (config.log and config.log->enabled (TrainingLog::INFO)) {
+        ostringstream o;
+        o << "resuming at tree " << first_tree + 1
+            << " of " << config.num_trees;
+        config.log->message (TrainingLog::INFO, o.str ());
+    }
+}
+
+}
+
+boost::shared_ptr<Model>
+BDTLearner::train_given_config (
+    const BDTConfig& config,
     const vector<Event>& all_sig_events, const vector<Event>& all_bg_events,
     const vector<double>& init_sig_weights,
-    const vector<double>& init_bg_weights) const
+    const vector<double>& init_bg_weights,
+    const BDTCheckpoint* checkpoint,
+    TrainingStatus* status) const
 {
     typedef vector<Event> vecev;
     typedef vector<double> vecd;
@@ -224,6 +756,12 @@ BDTLearner::train_given_everything (
     typedef vecd::iterator vecd_iter;
     using namespace np;
 
+    if (config.boost_type == "newton") {
+        return train_newton (config, all_sig_events, all_bg_events,
+                             init_sig_weights, init_bg_weights,
+                             checkpoint, status);
+    }
+
     int n_sig (all_sig_events.size ());
     int n_bg (all_bg_events.size ());
     int N_f (all_sig_events[0].size ());
@@ -232,48 +770,82 @@ BDTLearner::train_given_everything (
     vector<double> all_bg_weights (
         div (init_bg_weights, sum (init_bg_weights)));
 
-    // Warning: technically, this usage of dtl.min_split is not threadsafe
-    DTLearner& dtl (*m_dtlearner);
+    // the tree options and random numbers for this training only; the
+    // DTLearner itself is never modified
+    const DTLearner& dtl (*config.dtlearner);
+    DTConfig dt_config (config.dt);
+    RandomSampler sampler (config.seed);
+    TrainingProfile* const profile (config.dt.profile.get ());
 //TODO: Add to Booster Class
 
-    RegLearner& rdtl (static_cast<RegLearner&>(*m_dtlearner));
-    rdtl.separation_type("sum_squared");
-    std::cout<<rdtl.separation_type()<<std::endl;
-    int save_min_split (m_dtlearner->m_min_split);
-    dtl.min_split (max (
-        dtl.min_split (),
-        static_cast<int> (1.0 * (n_sig + n_bg) / N_f / N_f / 20)));
+    dt_config.sep_func = boost::make_shared<SumSquaredError> ();
+    if (config.log) {
+        config.log->message (
+            TrainingLog::DEBUG,
+            "separation type " + dt_config.sep_func->separation_type ());
+    }
+    dt_config.min_split = max (
+        dt_config.min_split,
+        static_cast<int> (1.0 * (n_sig + n_bg) / N_f / N_f / 20));
 
     vector<boost::shared_ptr<DTModel> > dtmodels;
     vector<double> errs;
     vector<double> alphas;
-//TODO: Overload function to take map
-    std::map<const DTNode*,double> alpha_j;
-    Notifier<int> notifier ("training decision trees", m_num_trees);
-    if (not m_quiet) {
-        notifier.update (0);
-    }
-
-//Get median of classifier value. TODO:Add to booster class
-    double f_mmone = -9999;
-    double quant_val = 0.7;
-    std::map<const DTNode*,double> f_x;
-
-//    if(n_sig>n_bg){
-//      f_mmone = 1;
-//    }
-//    else if(n_bg>n_sig){
-//      f_mmone = -1;
-//    }
-//    else{
-//      f_mmone = 0;
-//    }
+    int first_tree (0);
+    if (checkpoint) {
+        // pick up where the checkpointed training left off
+        first_tree = checkpoint->n_trees ();
+        log_resume (config, first_tree);
+        for (int m = 0; m < first_tree; ++m) {
+            dtmodels.push_back (boost::make_shared<DTModel> (
+                    m_feature_names, checkpoint->roots[m]));
+        }
+        errs = checkpoint->errs;
+        alphas = checkpoint->alphas;
+        all_sig_weights = checkpoint->sig_weights;
+        all_bg_weights = checkpoint->bg_weights;
+        checkpoint->load_rng (sampler);
+        if (checkpoint->scores.empty () and config.after_pruners.size ()) {
+            // replaying the pruned trees would not give the scores
+            // boosting had, so the result would differ
+            throw std::runtime_error (
+                "checkpoints older than version 3 cannot be resumed "
+                "with after pruners");
+        }
+    }
+    Notifier<int> notifier ("training decision trees", config.num_trees);
+    if (not config.quiet) {
+        notifier.update (first_tree);
+    }
+
     Booster gradBoost(true,n_sig,n_bg);
-    //gradBoost.InitFX(n_sig,n_bg);
+    gradBoost.sketch_threshold = config.quantile_sketch_threshold;
+    gradBoost.InitEvents (div (init_sig_weights, sum (init_sig_weights)),
+                          div (init_bg_weights, sum (init_bg_weights)));
+    if (checkpoint and checkpoint->scores.size ()) {
+        // the saved trees may have been pruned after boosting, so only
+        // the saved scores are exactly those of the interrupted training
+        gradBoost.F = checkpoint->scores;
+    }
+    else {
+        for (int m = 0; m < first_tree; ++m) {
+            gradBoost.AddTree (
+                *dtmodels[m]->root (), all_sig_events, all_bg_events);
+        }
+    }
 //Iterate over requested number of trees
-    for (int m = 0; m < m_num_trees; ++m) {
-        const int n_sig_used = static_cast<int>((m_frac_random_events * n_sig));
-        const int n_bg_used = static_cast<int> ((m_frac_random_events * n_bg));
+    for (int m = first_tree; m < config.num_trees; ++m) {
+        if (status) {
+            status->check ();
+        }
+        const ptime tree_start (now ());
+        // each tree draws from its own stream, so that tree m is the same
+        // however training got to it (e.g. resumed from a checkpoint)
+        RandomSampler tree_sampler (sampler.stream (m));
+        const int n_sig_used = static_cast<int> (
+            (config.frac_random_events * n_sig));
+        const int n_bg_used = static_cast<int> (
+            (config.frac_random_events * n_bg));
         const int n_sig_unused = (n_sig - n_sig_used);
         const int n_bg_unused = (n_bg - n_bg_used);
         // storage for picked events, if not using all events
@@ -286,16 +858,63 @@ BDTLearner::train_given_everything (
         const vector<Event>* bg_events;
         const vector<double>* bg_weights;
         // if desired, pick events
-        if (n_sig_unused > 0 or n_bg_unused > 0) {
+        if (config.sampling == "weighted") {
+            ProfileScope bagging_scope (
+                profile, "bagging", n_sig + n_bg,
+                (n_sig + n_bg) * (sizeof (double) + 2 * sizeof (unsigned))
+                + (n_sig_used + n_bg_used)
+                * (sizeof (int) + sizeof (Event) + sizeof (double)));
+            weighted_subsample (
+                tree_sampler, n_sig_used, all_sig_events, all_sig_weights,
+                picked_sig_events, picked_sig_weights);
+            weighted_subsample (
+                tree_sampler, n_bg_used, all_bg_events, all_bg_weights,
+                picked_bg_events, picked_bg_weights);
+            sig_events = &picked_sig_events;
+            sig_weights = &picked_sig_weights;
+            bg_events = &picked_bg_events;
+            bg_weights = &picked_bg_weights;
+        }
+        else if (config.sampling == "goss") {
+            ProfileScope bagging_scope (
+                profile, "bagging", n_sig + n_bg,
+                (n_sig + n_bg) * sizeof (int));
+            vector<int> indices;
+            vector<double> factors;
+            goss_indices (tree_sampler, config.goss_top, config.goss_rest,
+                          all_sig_weights, indices, factors);
+            picked_sig_events = np::subscript (all_sig_events, indices);
+            picked_sig_weights =
+                np::mul (np::subscript (all_sig_weights, indices), factors);
+            goss_indices (tree_sampler, config.goss_top, config.goss_rest,
+                          all_bg_weights, indices, factors);
+            picked_bg_events = np::subscript (all_bg_events, indices);
+            picked_bg_weights =
+                np::mul (np::subscript (all_bg_weights, indices), factors);
+            // for each pick its index, draw and factor, event, and a
+            // subscript and product of the weights
+            bagging_scope.add_est_bytes (
+                (picked_sig_events.size () + picked_bg_events.size ())
+                * (2 * sizeof (int) + sizeof (Event) + 3 * sizeof (double)));
+            sig_events = &picked_sig_events;
+            sig_weights = &picked_sig_weights;
+            bg_events = &picked_bg_events;
+            bg_weights = &picked_bg_weights;
+        }
+        else if (n_sig_unused > 0 or n_bg_unused > 0) {
+            ProfileScope bagging_scope (
+                profile, "bagging", n_sig_used + n_bg_used,
+                (n_sig_used + n_bg_used)
+                * (sizeof (int) + sizeof (Event) + sizeof (double)));
             const vector<int> sig_indices (
-                dtl.m_random_sampler.sample_range<int> (
+                tree_sampler.sample_range<int> (
                     n_sig_used, 0, n_sig, true));
             picked_sig_events =
                 np::subscript (all_sig_events, sig_indices);
             picked_sig_weights =
                 np::subscript (all_sig_weights, sig_indices);
             const vector<int> bg_indices (
-                dtl.m_random_sampler.sample_range<int> (
+                tree_sampler.sample_range<int> (
                     n_bg_used, 0, n_bg, true));
             picked_bg_events =
                 np::subscript (all_bg_events, bg_indices);
@@ -313,103 +932,37 @@ BDTLearner::train_given_everything (
             bg_weights = &all_bg_weights;
         }
 
-        boost::shared_ptr<Model> model (
-            dtl.train_given_everything (
-                *sig_events, *bg_events, *sig_weights, *bg_weights));
+        ProfileScope tree_scope (
+            profile, "tree", sig_events->size () + bg_events->size ());
         boost::shared_ptr<DTModel> dtmodel (
-            dynamic_pointer_cast<DTModel> (model));
+            dtl.train_given_config (
+                dt_config, tree_sampler,
+                *sig_events, *bg_events, *sig_weights, *bg_weights));
         dtmodels.push_back (dtmodel);
+        tree_scope.stop ();
         // TODO: if there are unused events, set purity from unused?
 
-        std::cout<<" Melanie was here "<<std::endl;
-//Iterate over nodes and get coefficient for each
-        boost::shared_ptr<DTNode> dtNode = dtmodel->root(); 
-        dtnresmap resMap;
-        vecd_iter my_w;
-        vecev_citer my_ev;
-        vecpdd resPairs;
-//Get residuals for delta TODO: Make this a function
-        for(my_ev = sig_events->begin(),
-            my_w = all_sig_weights.begin();
-            my_ev != sig_events->end(); ++my_ev, ++my_w) {
-          const DTNode& eLeaf (dtNode->trace(make_scoreable(*my_ev)));
-          const DTNode* pLeaf = &eLeaf;
-          double leaf_res = 1;
-          double f_xi;
-          f_x.find(pLeaf)!=f_x.end() ? f_xi = f_x[pLeaf] : f_xi = gradBoost.f_mmone;
-          std::cout<<"First f_x: "<<f_xi<<" "<<gradBoost.f_mmone<<" "<<pLeaf<<std::endl;
-          resPairs.push_back(make_pair(leaf_res-f_xi,*my_w)); 
-        }
-        for(my_ev = bg_events->begin(),
-            my_w = all_bg_weights.begin();
-            my_ev != bg_events->end(); ++my_ev, ++my_w) {
-          const DTNode& eLeaf (dtNode->trace(make_scoreable(*my_ev)));
-          const DTNode* pLeaf = &eLeaf;
-          double leaf_res = -1;
-          double f_xi;
-          f_x.find(pLeaf)!=f_x.end() ? f_xi = f_x[pLeaf] : f_xi = gradBoost.f_mmone;
-          std::cout<<"First f_x: "<<f_xi<<" "<<gradBoost.f_mmone<<" "<<pLeaf<<std::endl;
-          resPairs.push_back(make_pair(leaf_res-f_xi,*my_w)); 
-        }
-//Update delta
-        double delta = GetQuantile(resPairs,quant_val,true,2);
-//Get residuals for signal TODO:Make this a function
-        for(my_ev = sig_events->begin(),
-            my_w = all_sig_weights.begin();
-            my_ev != sig_events->end(); ++my_ev, ++my_w) {
-          const DTNode& eLeaf (dtNode->trace(make_scoreable(*my_ev)));
-          const DTNode* pLeaf = &eLeaf;
-          double leaf_res = 1;
-          double sign_leaf_res = boost::math::sign(leaf_res);
-          resMap[pLeaf].weightSum+=*my_w;
-          resMap[pLeaf].resPair.push_back(make_pair(sign_leaf_res*min(fabs(leaf_res-delta),delta),*my_w));
-        }
-//Get residuals for background TODO:Make this a function 
-        for(my_ev = bg_events->begin(),
-            my_w = all_bg_weights.begin();
-            my_ev != bg_events->end(); ++my_ev, ++my_w) {
-          const DTNode& eLeaf (dtNode->trace(make_scoreable(*my_ev)));
-          const DTNode* pLeaf = &eLeaf;
-          double leaf_res = -1;
-          double sign_leaf_res = boost::math::sign(leaf_res);
-          resMap[pLeaf].weightSum+=*my_w;
-          resMap[pLeaf].resPair.push_back(make_pair(sign_leaf_res*min(fabs(leaf_res-delta),delta),*my_w));
-        }
-//TODO: Make this a function
-        for(dtnresmap_citer n_map = resMap.begin();
-            n_map != resMap.end(); ++n_map){
-//TODO: Add this to Booster Class
-//Residual and Weight pair
-          vecpdd nPair = n_map->second.resPair; 
-          double r_bar = GetQuantile(nPair,0.5,true,n_map->second.weightSum);
-          double tot_gamma = 0;
-          double gamma_j = 0;
-//Calculate gammas for each node TODO: Make this a function
-          for(vecpdd_iter pair_i = nPair.begin();
-              pair_i != nPair.end(); pair_i++){
-//Node residual variables
-            double res_i = pair_i->first; 
-            double meddiff_i = res_i-r_bar;
-            double sign_meddiff_i = boost::math::sign(meddiff_i); 
-            double min_i = std::min(delta,meddiff_i);
-            double gsum_i = sign_meddiff_i*min_i;
-            gamma_j += gsum_i;
-//       std::cout<<(1/(sig_size+bg_size))<<" "<<((sig_size*sig_gamma)+(bg_size*bg_gamma))<<" "<<delta<<" "<<sig_res<<" "<<r_bar<<" "<<sig_meddiff<<" "<<sig_sign_meddiff<<" "<<sig_min<<" "<<sig_gamma<<" "<<bg_gamma<<" "<<tot_gamma<<std::endl;
-          }//End vecpdd loop
-//Get map of node weights
-          alpha_j[n_map->first] = r_bar + (1/nPair.size())*gamma_j;
-          f_x[n_map->first] += alpha_j[n_map->first];
-          std::cout<<"Delta: "<<delta<<" F(x): "<<f_x[n_map->first]<<" Point: "<<n_map->first<<std::endl;
-        }//End dtnresmap loop 
-
         // before pruners get to prune before boosting
+        ProfileScope prune_scope (profile, "prune");
         for (vector<boost::shared_ptr<Pruner> >::const_iterator i_pruner
-             = m_before_pruners.begin (); i_pruner != m_before_pruners.end ();
+             = config.before_pruners.begin ();
+             i_pruner != config.before_pruners.end ();
              ++i_pruner) {
             (*i_pruner)->prune (dtmodel);
         }
+        prune_scope.stop ();
+
+        // gradient boosting: fit the leaf responses to the residuals
+        ProfileScope gradient_scope (
+            profile, "gradient", n_sig + n_bg,
+            (n_sig + n_bg) * (sizeof (int) + 2 * sizeof (double)));
+        gradBoost.Boost (*dtmodel->root (), all_sig_events, all_bg_events);
+        gradient_scope.stop ();
 
         // get scores for boosting
+        ProfileScope rescore_scope (
+            profile, "rescore", n_sig + n_bg,
+            2 * (n_sig + n_bg) * sizeof (double));
         const vector<double> all_sig_result (
             dtmodel->score (all_sig_events, false, true));
         const vector<double> all_bg_result (
@@ -442,8 +995,8 @@ BDTLearner::train_given_everything (
         // AdaBoost: boost weights of misclass'd events
         const double err_m ((sum_wrong_sig_weights + sum_wrong_bg_weights)
                             / (sum_sig_weights + sum_bg_weights));
-        const double boost_factor = pow ((1-err_m)/err_m, m_beta);
-        const double alpha_m = m_beta ? log (boost_factor) : 1;
+        const double boost_factor = pow ((1-err_m)/err_m, config.beta);
+        const double alpha_m = config.beta ? log (boost_factor) : 1;
         for (i_weight = all_sig_weights.begin (),
              i_result = all_sig_result.begin(),
              i_ev = all_sig_events.begin ();
@@ -469,72 +1022,222 @@ BDTLearner::train_given_everything (
             sum (all_sig_weights) + sum (all_bg_weights));
         all_sig_weights = div (all_sig_weights, new_total_weight);
         all_bg_weights = div (all_bg_weights, new_total_weight);
+        rescore_scope.stop ();
 
         // after pruners get to prune after boosting
+        ProfileScope after_prune_scope (profile, "prune");
         for (vector<boost::shared_ptr<Pruner> >::const_iterator i_pruner
-             = m_after_pruners.begin (); i_pruner != m_after_pruners.end ();
+             = config.after_pruners.begin ();
+             i_pruner != config.after_pruners.end ();
              ++i_pruner) {
             (*i_pruner)->prune (dtmodel);
         }
-        if (not m_quiet) {
+        after_prune_scope.stop ();
+        log_tree (config, m, err_m, alpha_m, *dtmodel, tree_start);
+
+        // save progress every checkpoint_interval trees
+        if (config.checkpoint_interval > 0
+            and config.checkpoint_filename.size ()
+            and (m + 1) % config.checkpoint_interval == 0) {
+            ProfileScope checkpoint_scope (profile, "checkpoint");
+            BDTCheckpoint out;
+            out.feature_names = m_feature_names;
+            for (int i_tree = 0; i_tree <= m; ++i_tree) {
+                out.roots.push_back (dtmodels[i_tree]->root ());
+            }
+            out.errs = errs;
+            out.alphas = alphas;
+            out.sig_weights = all_sig_weights;
+            out.bg_weights = all_bg_weights;
+            out.scores = gradBoost.F;
+            out.save_rng (sampler);
+            out.save (config.checkpoint_filename);
+        }
+        if (status) {
+            status->progress ((m + 1.) / config.num_trees);
+        }
+        if (not config.quiet) {
             notifier.update (m + 1);
         }
     }
-    if (not m_quiet) {
+    if (not config.quiet) {
         notifier.finish ();
     }
-    dtl.min_split (save_min_split);
     return boost::make_shared<BDTModel> (m_feature_names, dtmodels, alphas);
 }
 
-void
-export_bdtlearner ()
+boost::shared_ptr<Model>
+BDTLearner::train_newton (
+    const BDTConfig& config,
+    const vector<Event>& all_sig_events, const vector<Event>& all_bg_events,
+    const vector<double>& init_sig_weights,
+    const vector<double>& init_bg_weights,
+    const BDTCheckpoint* checkpoint,
+    TrainingStatus* status) const
 {
-    using namespace boost::python;
-    class_<Booster> (
-        "Booster",
-        init<bool,double,double> ());
-
-    class_<BDTLearner, bases<Learner> > (
-        "BDTLearner",
-        "Train a boosted decision tree.\n\n"
-        "The feature_names, sig_weight_name and bg_weight_name are chosen\n"
-        "at construction and are intrinsic to each BDTLearner.  After\n"
-        "construction, various options can be set and one or more\n"
-        "boosted decision trees can be be trained.  Each training\n"
-        "results in a new Model object."
-        ,init<py::list>())
-        .def (init<py::list,string> ())
-        .def (init<py::list,string,string> ())
-        .add_property (
-            "dtlearner", &BDTLearner::dtlearner)
-        .add_property (
-            "beta",
-            (double (BDTLearner::*)()const) &BDTLearner::beta,
-            (void (BDTLearner::*)(double)) &BDTLearner::beta)
-        .add_property (
-            "frac_random_events",
-            (double (BDTLearner::*)()const) &BDTLearner::frac_random_events,
-            (void (BDTLearner::*)(double)) &BDTLearner::frac_random_events)
-        .add_property (
-            "num_trees", 
-            (int (BDTLearner::*)()const) &BDTLearner::num_trees,
-            (void (BDTLearner::*)(int)) &BDTLearner::num_trees)
-        .add_property (
-            "quiet", 
-            (bool (BDTLearner::*)()const) &BDTLearner::quiet,
-            (void (BDTLearner::*)(bool)) &BDTLearner::quiet)
-        .add_property (
-            "after_pruners", &BDTLearner::after_pruners)
-        .add_property (
-            "before_pruners", &BDTLearner::before_pruners)
-        .def ("add_after_pruner", &BDTLearner::add_before_pruner)
-        .def ("add_before_pruner", &BDTLearner::add_before_pruner)
-        .def ("clear_after_pruners", &BDTLearner::clear_after_pruners)
-        .def ("clear_before_pruners", &BDTLearner::clear_before_pruners)
-        .def ("set_defaults", &BDTLearner::set_defaults)
-        ;
-
-    register_ptr_to_python <boost::shared_ptr<BDTLearner> > ();
-    register_ptr_to_python <boost::shared_ptr<Booster> > ();
+    using namespace np;
+
+    if (config.before_pruners.size () or config.after_pruners.size ()) {
+        throw std::runtime_error (
+            "pruners are not supported with boost_type \"newton\"");
+    }
+    if (config.sampling == "weighted") {
+        throw std::runtime_error (
+            "sampling \"weighted\" is not supported with boost_type "
+            "\"newton\"");
+    }
+    const int n_sig (all_sig_events.size ());
+    const int n_bg (all_bg_events.size ());
+    // each class gets half the total weight, at a mean of 1 per event, so
+    // that l2 is on the scale of a single event's hessian
+    const double scale ((n_sig + n_bg) / 2.);
+    const vector<double> all_sig_weights (
+        mul (div (init_sig_weights, sum (init_sig_weights)), scale));
+    const vector<double> all_bg_weights (
+        mul (div (init_bg_weights, sum (init_bg_weights)), scale));
+    const double f0 (log (sum (all_sig_weights) / sum (all_bg_weights)));
+
+    const DTLearner& dtl (*config.dtlearner);
+    RandomSampler sampler (config.seed);
+    TrainingProfile* const profile (config.dt.profile.get ());
+    vector<boost::shared_ptr<DTModel> > dtmodels;
+    // per tree: training loss after the tree, and the learning rate
+    vector<double> losses;
+    vector<double> rates;
+    Booster gradBoost(false,n_sig,n_bg);
+    gradBoost.f_mmone = f0;
+    gradBoost.InitEvents (all_sig_weights, all_bg_weights);
+    int first_tree (0);
+    if (checkpoint) {
+        first_tree = checkpoint->n_trees ();
+        log_resume (config, first_tree);
+        for (int m = 0; m < first_tree; ++m) {
+            dtmodels.push_back (boost::make_shared<DTModel> (
+                    m_feature_names, checkpoint->roots[m]));
+            if (checkpoint->scores.empty ()) {
+                gradBoost.AddTree (
+                    *dtmodels[m]->root (), all_sig_events, all_bg_events);
+            }
+        }
+        if (checkpoint->scores.size ()) {
+            gradBoost.F = checkpoint->scores;
+        }
+        losses = checkpoint->errs;
+        rates = checkpoint->alphas;
+        checkpoint->load_rng (sampler);
+    }
+    Notifier<int> notifier ("training decision trees", config.num_trees);
+    if (not config.quiet) {
+        notifier.update (first_tree);
+    }
+
+    vector<double> all_sig_g, all_sig_h, all_bg_g, all_bg_h;
+    for (int m = first_tree; m < config.num_trees; ++m) {
+        if (status) {
+            status->check ();
+        }
+        const ptime tree_start (now ());
+        ProfileScope gradient_scope (profile, "gradient", n_sig + n_bg);
+        gradBoost.LogisticGradients (all_sig_g, all_sig_h, all_bg_g, all_bg_h);
+        gradient_scope.stop ();
+        RandomSampler tree_sampler (sampler.stream (m));
+        const int n_sig_used = static_cast<int> (
+            (config.frac_random_events * n_sig));
+        const int n_bg_used = static_cast<int> (
+            (config.frac_random_events * n_bg));
+        boost::shared_ptr<DTModel> dtmodel;
+        ProfileScope tree_scope (
+            profile, "tree", n_sig_used + n_bg_used);
+        if (config.sampling == "goss") {
+            // one-side sampling on the gradients, which already carry the
+            // event weights; the hessians are scaled along with them
+            vector<int> sig_indices, bg_indices;
+            vector<double> sig_factors, bg_factors;
+            goss_indices (tree_sampler, config.goss_top, config.goss_rest,
+                          all_sig_g, sig_indices, sig_factors);
+            goss_indices (tree_sampler, config.goss_top, config.goss_rest,
+                          all_bg_g, bg_indices, bg_factors);
+            // the ranking, then for each pick its index, draw and factor,
+            // event, and a subscript and product of four columns
+            tree_scope.add_est_bytes (
+                (n_sig + n_bg) * sizeof (int)
+                + (sig_indices.size () + bg_indices.size ())
+                * (2 * sizeof (int) + sizeof (Event) + 9 * sizeof (double)));
+            dtmodel = dtl.train_given_gradients (
+                config.dt, tree_sampler,
+                subscript (all_sig_events, sig_indices),
+                subscript (all_bg_events, bg_indices),
+                mul (subscript (all_sig_weights, sig_indices), sig_factors),
+                mul (subscript (all_bg_weights, bg_indices), bg_factors),
+                mul (subscript (all_sig_g, sig_indices), sig_factors),
+                mul (subscript (all_sig_h, sig_indices), sig_factors),
+                mul (subscript (all_bg_g, bg_indices), bg_factors),
+                mul (subscript (all_bg_h, bg_indices), bg_factors),
+                config.learning_rate, config.l2);
+        }
+        else if (n_sig_used < n_sig or n_bg_used < n_bg) {
+            const vector<int> sig_indices (
+                tree_sampler.sample_range<int> (n_sig_used, 0, n_sig, true));
+            const vector<int> bg_indices (
+                tree_sampler.sample_range<int> (n_bg_used, 0, n_bg, true));
+            dtmodel = dtl.train_given_gradients (
+                config.dt, tree_sampler,
+                subscript (all_sig_events, sig_indices),
+                subscript (all_bg_events, bg_indices),
+                subscript (all_sig_weights, sig_indices),
+                subscript (all_bg_weights, bg_indices),
+                subscript (all_sig_g, sig_indices),
+                subscript (all_sig_h, sig_indices),
+                subscript (all_bg_g, bg_indices),
+                subscript (all_bg_h, bg_indices),
+                config.learning_rate, config.l2);
+        }
+        else {
+            dtmodel = dtl.train_given_gradients (
+                config.dt, tree_sampler,
+                all_sig_events, all_bg_events,
+                all_sig_weights, all_bg_weights,
+                all_sig_g, all_sig_h, all_bg_g, all_bg_h,
+                config.learning_rate, config.l2);
+        }
+        dtmodels.push_back (dtmodel);
+        tree_scope.stop ();
+        ProfileScope rescore_scope (
+            profile, "rescore", n_sig + n_bg, (n_sig + n_bg) * sizeof (int));
+        gradBoost.AddTree (*dtmodel->root (), all_sig_events, all_bg_events);
+        losses.push_back (gradBoost.LogisticLoss ());
+        rescore_scope.stop ();
+        rates.push_back (config.learning_rate);
+        log_tree (config, m, losses.back (), rates.back (),
+                  *dtmodel, tree_start);
+
+        // save progress every checkpoint_interval trees
+        if (config.checkpoint_interval > 0
+            and config.checkpoint_filename.size ()
+            and (m + 1) % config.checkpoint_interval == 0) {
+            ProfileScope checkpoint_scope (profile, "checkpoint");
+            BDTCheckpoint out;
+            out.feature_names = m_feature_names;
+            for (int i_tree = 0; i_tree <= m; ++i_tree) {
+                out.roots.push_back (dtmodels[i_tree]->root ());
+            }
+            out.errs = losses;
+            out.alphas = rates;
+            out.sig_weights = all_sig_weights;
+            out.bg_weights = all_bg_weights;
+            out.scores = gradBoost.F;
+            out.save_rng (sampler);
+            out.save (config.checkpoint_filename);
+        }
+        if (status) {
+            status->progress ((m + 1.) / config.num_trees);
+        }
+        if (not config.quiet) {
+            notifier.update (m + 1);
+        }
+    }
+    if (not config.quiet) {
+        notifier.finish ();
+    }
+    return boost::make_shared<GBModel> (m_feature_names, dtmodels, f0);
 }
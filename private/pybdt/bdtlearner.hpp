@@ -13,13 +13,14 @@
 #include <boost/tuple/tuple.hpp>
 #include <boost/math/special_functions/sign.hpp>
 
-#include "boost_python.hpp"
-
 #include "bdtmodel.hpp"
+#include "checkpoint.hpp"
 #include "dataset.hpp"
 #include "dtlearner.hpp"
 #include "learner.hpp"
 #include "pruner.hpp"
+#include "quantile.hpp"
+#include "training_log.hpp"
 
 class Booster {
 public:
@@ -27,28 +28,81 @@ public:
   double f_mmone;
   double quant_val;
   int p;
-  std::map<const DTNode*,double> f_x;
+//Inputs with more pairs than this use a QuantileSketch (0: always exact)
+  int sketch_threshold;
+//Current score of every event, signal events first
+  std::vector<double> F;
   Booster(bool init_bool,double nsig,double nbg);
 //Clark always told me, act like anything can become a base class. Still don't believe in trusting everyone to use boost shared pointers
   virtual ~Booster();
   void InitFX(double,double,bool useInit=true);
+//Start F at f_mmone for events with the given weights
+  void InitEvents(const std::vector<double>& sig_weights,
+                  const std::vector<double>& bg_weights);
+//Add the leaf responses of an already boosted tree to F
+  void AddTree(DTNode& root, const std::vector<Event>& sig,
+               const std::vector<Event>& bg);
+//Logistic loss gradients and hessians of every event at the current F
+  void LogisticGradients(std::vector<double>& sig_g,
+                         std::vector<double>& sig_h,
+                         std::vector<double>& bg_g,
+                         std::vector<double>& bg_h) const;
+//Weighted mean logistic loss at the current F
+  double LogisticLoss() const;
+//Fit the leaf responses of root to the Huber loss of F and add them to F
+  void Boost(DTNode& root, const std::vector<Event>& sig,
+             const std::vector<Event>& bg);
+//Weighted quantile of residual/weight pairs; reorders [first, last)
+  double Quantile(vecpdd_iter first, vecpdd_iter last,
+                  double quant_val, double weightSum) const;
+private:
+//A node of the flattened tree: internal nodes have their children at
+//left and left + 1, leaves have left = -1 and their index in leaves
+  struct FlatNode{
+    int feature;
+    double value;
+    int left;
+    int leaf;
+  };
+//Fill leaves with the leaves of root and leaf with each event's index in it
+  void TraceLeaves(DTNode& root, const std::vector<Event>& sig,
+                   const std::vector<Event>& bg);
+//Index in leaves of the leaf of the last traced tree that e falls in
+  int TraceLeaf(const Event& e) const;
+  std::vector<FlatNode> nodes;
+  std::vector<double> y;
+  std::vector<double> w;
+  std::vector<int> leaf;
+  std::vector<DTNode*> leaves;
+  vecpdd pairs;
 };
 
-//TODO: Put this somewhere nicer (Booster?)
-typedef std::vector<std::pair<double,double> > vecpdd;
-typedef vecpdd::iterator vecpdd_iter;
-
-//TODO: Make struct member of class, probably Booster(when that exists)
-struct NodeResidualPair{
-  double weightSum;
-  vecpdd resPair;
+// Snapshot of the BDTLearner options used for one training; see DTConfig.
+struct BDTConfig {
+    boost::shared_ptr<const DTLearner> dtlearner;
+    DTConfig dt;
+    int seed;
+    std::string boost_type;
+    double beta;
+    std::string checkpoint_filename;
+    int checkpoint_interval;
+    double frac_random_events;
+    double goss_rest;
+    double goss_top;
+    double learning_rate;
+    double l2;
+    int num_trees;
+    int quantile_sketch_threshold;
+    bool quiet;
+    // tags this training's TreeRecords; see TreeRecord::run
+    std::string run;
+    std::string sampling;
+    boost::shared_ptr<TrainingLog> log;
+    std::vector<boost::shared_ptr<Pruner> > before_pruners;
+    std::vector<boost::shared_ptr<Pruner> > after_pruners;
 };
 
-typedef std::map<const DTNode*, NodeResidualPair> dtnresmap;
-typedef dtnresmap::const_iterator dtnresmap_citer;
-
 class BDTLearner : public Learner {
-    friend class BDTLearner_pickle_suite;
 public:
 
 
@@ -61,33 +115,57 @@ public:
                 const std::string& sig_weight_name,
                 const std::string& bg_weight_name);
 
-    // structors for Python
-
-    explicit BDTLearner (const boost::python::list& feature_names,
-                         const std::string& weight_name="");
-
-    BDTLearner (const boost::python::list& feature_names,
-                const std::string& sig_weight_name,
-                const std::string& bg_weight_name);
-
     virtual ~BDTLearner ();
     // inspectors
 
     double beta () const;
+    std::string boost_type () const;
+    std::string checkpoint_filename () const;
+    int checkpoint_interval () const;
     double frac_random_events () const;
+    double goss_rest () const;
+    double goss_top () const;
+    double l2 () const;
+    double learning_rate () const;
     int num_trees () const;
+    int quantile_sketch_threshold () const;
     bool quiet () const;
+    // how each tree's events are picked when frac_random_events < 1:
+    // "uniform" bags uniformly with replacement, carrying the weights
+    // along; "weighted" draws with probability proportional to the
+    // current boosting weight, each pick carrying an equal weight;
+    // "goss" ignores frac_random_events and keeps the goss_top fraction
+    // of events with the largest weight (AdaBoost) or gradient (newton)
+    // plus a goss_rest fraction of the others, scaled up to stand in for
+    // all of them
+    std::string sampling () const;
+
+    BDTConfig config () const;
 
-    boost::python::list after_pruners () const;
-    boost::python::list before_pruners () const;
+    boost::shared_ptr<TrainingLog> training_log () const;
+    boost::shared_ptr<TrainingProfile> profile () const;
+    bool profiling () const;
+
+    std::vector<boost::shared_ptr<Pruner> > after_pruners () const;
+    std::vector<boost::shared_ptr<Pruner> > before_pruners () const;
 
 
     // mutators
 
     void beta (double beta);
+    void boost_type (const std::string& type);
+    void checkpoint_filename (const std::string& filename);
+    void checkpoint_interval (int n);
     void frac_random_events (double n);
+    void goss_rest (double frac);
+    void goss_top (double frac);
+    void l2 (double l2);
+    void learning_rate (double rate);
     void num_trees (int n);
+    void profiling (bool value);
+    void quantile_sketch_threshold (int n);
     void quiet (bool val);
+    void sampling (const std::string& sampling);
 
     void add_after_pruner (boost::shared_ptr<Pruner> pruner);
     void add_before_pruner (boost::shared_ptr<Pruner> pruner);
@@ -95,20 +173,80 @@ public:
     void clear_before_pruners ();
     void set_defaults ();
 
+    // throw unless sampling is a known sampling mode
+    static void check_sampling (const std::string& sampling);
+
     boost::shared_ptr<DTLearner> dtlearner ();
 
     virtual boost::shared_ptr<Model> train_given_everything (
         const std::vector<Event>& sig, const std::vector<Event>& bg,
         const std::vector<double>& init_sig_weights,
-        const std::vector<double>& init_bg_weights) const;
+        const std::vector<double>& init_bg_weights,
+        TrainingStatus* status=0) const;
+
+    // clears training_log ()
+    virtual void start_training () const;
+
+    // trains from config () made quiet and without checkpoints
+    virtual boost::shared_ptr<Model> train_quietly (
+        const std::vector<Event>& sig, const std::vector<Event>& bg,
+        const std::vector<double>& init_sig_weights,
+        const std::vector<double>& init_bg_weights,
+        const std::string& run,
+        TrainingStatus* status=0) const;
+
+    // train one model per config on up to num_threads threads, sharing a
+    // single projected and NaN-filtered copy of sig and bg; the trainings
+    // are quiet and never checkpointed, whatever the configs say, and
+    // those with an empty run are logged as run "grid <index>"
+    std::vector<boost::shared_ptr<Model> > train_grid (
+        const DataSet& sig, const DataSet& bg,
+        const std::vector<BDTConfig>& configs, int num_threads) const;
+
+    // continue the training saved in checkpoint_filename; sig and bg must
+    // be the DataSets the interrupted training was started with
+    boost::shared_ptr<Model> resume (
+        const DataSet& sig, const DataSet& bg,
+        TrainingStatus* status=0) const;
+
+    // train with the given options, optionally continuing from checkpoint;
+    // re-entrant, so may be called concurrently from several threads
+    boost::shared_ptr<Model> train_given_config (
+        const BDTConfig& config,
+        const std::vector<Event>& sig, const std::vector<Event>& bg,
+        const std::vector<double>& init_sig_weights,
+        const std::vector<double>& init_bg_weights,
+        const BDTCheckpoint* checkpoint=0,
+        TrainingStatus* status=0) const;
+
 protected:
 
+    // train_given_config for boost_type "newton"
+    boost::shared_ptr<Model> train_newton (
+        const BDTConfig& config,
+        const std::vector<Event>& sig, const std::vector<Event>& bg,
+        const std::vector<double>& init_sig_weights,
+        const std::vector<double>& init_bg_weights,
+        const BDTCheckpoint* checkpoint,
+        TrainingStatus* status) const;
+
+
     boost::shared_ptr<DTLearner> m_dtlearner;
 
     double m_beta;
+    std::string m_boost_type;
+    std::string m_checkpoint_filename;
+    int m_checkpoint_interval;
     double m_frac_random_events;
+    double m_goss_rest;
+    double m_goss_top;
+    double m_l2;
+    double m_learning_rate;
     int m_num_trees;
+    int m_quantile_sketch_threshold;
     bool m_quiet;
+    std::string m_sampling;
+    boost::shared_ptr<TrainingLog> m_log;
 
     std::vector<boost::shared_ptr<Pruner> > m_before_pruners;
     std::vector<boost::shared_ptr<Pruner> > m_after_pruners;
@@ -117,7 +255,4 @@ protected:
 };
 
 
-
-void export_bdtlearner ();
-
 #endif  /* PYBDT_BDTLEARNER_HPP */
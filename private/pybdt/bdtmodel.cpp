@@ -1,17 +1,16 @@
 // bdtmodel.cpp
 
-#include <Python.h>
-
 #include "bdtmodel.hpp"
 
 #include "np.hpp"
+#include "parallel.hpp"
+#include "pruner.hpp"
 
 #include <cmath>
 #include <boost/make_shared.hpp>
 
 using namespace std;
 using namespace boost;
-namespace py = boost::python;
 
 
 BDTModel::BDTModel (const vector<string>& feature_names,
@@ -26,17 +25,6 @@ BDTModel::~BDTModel ()
 {
 }
 
-BDTModel::BDTModel (const py::list& feature_names,
-                    const py::list& dtmodels,
-                    const py::list& alphas)
-: Model (feature_names),
-    m_dtmodels (np::list_to_vector<boost::shared_ptr<DTModel> > (dtmodels)),
-    m_alphas (np::list_to_vector<double> (alphas)),
-    m_n_dtmodels (len (dtmodels))
-{
-    m_max_response = np::sum (m_alphas);
-}
-
 double
 BDTModel::get_alpha (int n) const
 {
@@ -85,20 +73,6 @@ BDTModel::event_variable_importance (
     return rel_var_imp;
 }
 
-py::dict
-BDTModel::event_variable_importance_py (
-    const py::list& vals, bool sep_weighted, bool tree_weighted) const
-{
-    vector<double> var_imp = event_variable_importance (
-        make_scoreable (np::list_to_vector<double> (vals)),
-        sep_weighted, tree_weighted);
-    py::dict out;
-    for (int i_f (0); i_f < m_n_features; ++i_f) {
-        out[m_feature_names[i_f]] = var_imp[i_f];
-    }
-    return out;
-}
-
 vector<double>
 BDTModel::variable_importance (bool sep_weighted, bool tree_weighted) const
 {
@@ -128,18 +102,6 @@ BDTModel::variable_importance (bool sep_weighted, bool tree_weighted) const
     return rel_var_imp;
 }
 
-py::dict
-BDTModel::variable_importance_py (bool sep_weighted, bool tree_weighted) const
-{
-    vector<double> var_imp = variable_importance (
-        sep_weighted, tree_weighted);
-    py::dict out;
-    for (int i_f (0); i_f < m_n_features; ++i_f) {
-        out[m_feature_names[i_f]] = var_imp[i_f];
-    }
-    return out;
-}
-
 boost::shared_ptr<BDTModel>
 BDTModel::get_subset_bdtmodel (int n_i, int n_f) const
 {
@@ -160,11 +122,10 @@ BDTModel::get_subset_bdtmodel (int n_i, int n_f) const
 }
 
 boost::shared_ptr<BDTModel>
-BDTModel::get_subset_bdtmodel_list (py::list dtmodel_indices) const
+BDTModel::get_subset_bdtmodel_list (const vector<int>& indices) const
 {
     vector<boost::shared_ptr<DTModel> > subset_dtmodels;
     vector<double> subset_alphas;
-    const vector<int> indices (np::list_to_vector<int> (dtmodel_indices));
     for (vector<int>::const_iterator i_index (indices.begin ());
          i_index != indices.end (); ++i_index) {
         int index (*i_index);
@@ -208,6 +169,47 @@ BDTModel::get_trimmed_bdtmodel (double threshold) const
         m_feature_names, subset_dtmodels, subset_alphas);
 }
 
+namespace {
+
+// prunes a copy of tree i for parallel::parallel_for
+struct TreePruner {
+    TreePruner (const vector<string>& feature_names,
+                const vector<boost::shared_ptr<DTModel> >& dtmodels,
+                Pruner& pruner,
+                vector<boost::shared_ptr<DTModel> >& pruned)
+        : feature_names (feature_names), dtmodels (dtmodels),
+        pruner (pruner), pruned (pruned)
+    { }
+
+    void operator() (int i)
+    {
+        pruned[i] = boost::make_shared<DTModel> (
+            feature_names, dtmodels[i]->root ()->get_copy ());
+        pruner.prune (pruned[i]);
+    }
+
+    const vector<string>& feature_names;
+    const vector<boost::shared_ptr<DTModel> >& dtmodels;
+    Pruner& pruner;
+    vector<boost::shared_ptr<DTModel> >& pruned;
+};
+
+}
+
+boost::shared_ptr<BDTModel>
+BDTModel::pruned (boost::shared_ptr<Pruner> pruner, int num_threads) const
+{
+    if (not pruner) {
+        throw std::runtime_error ("no pruner given");
+    }
+    vector<boost::shared_ptr<DTModel> > pruned_dtmodels (m_n_dtmodels);
+    TreePruner tree_pruner (
+        m_feature_names, m_dtmodels, *pruner, pruned_dtmodels);
+    parallel::parallel_for (m_n_dtmodels, num_threads, tree_pruner);
+    return boost::make_shared<BDTModel> (
+        m_feature_names, pruned_dtmodels, m_alphas);
+}
+
 double
 BDTModel::base_score (const Scoreable& e, bool use_purity) const
 {
@@ -218,37 +220,3 @@ BDTModel::base_score (const Scoreable& e, bool use_purity) const
     }
     return min (1., max (-1., score));
 }
-
-py::tuple
-BDTModel_pickle_suite::getinitargs (const BDTModel& m)
-{
-    return py::make_tuple (
-        np::vector_to_list (m.m_feature_names),
-        np::vector_to_list (m.m_dtmodels),
-        np::vector_to_list (m.m_alphas));
-}
-
-void
-export_bdtmodel ()
-{
-
-    typedef const py::list& clr;
-
-    using namespace boost::python;
-    class_<BDTModel, bases<Model> > (
-        "BDTModel", init<clr,clr,clr> ())
-        .def ("get_alpha", &BDTModel::get_alpha)
-        .def ("get_dtmodel", &BDTModel::get_dtmodel)
-        .def ("get_subset_bdtmodel", &BDTModel::get_subset_bdtmodel)
-        .def ("get_subset_bdtmodel_list", &BDTModel::get_subset_bdtmodel_list)
-        .def ("get_trimmed_bdtmodel", &BDTModel::get_trimmed_bdtmodel)
-        .def ("event_variable_importance",
-              &BDTModel::event_variable_importance_py)
-        .def ("variable_importance",
-              &BDTModel::variable_importance_py)
-        .add_property ("n_dtmodels", &BDTModel::n_dtmodels)
-        .def_pickle (BDTModel_pickle_suite ())
-        ;
-
-    register_ptr_to_python <boost::shared_ptr<BDTModel> > ();
-}
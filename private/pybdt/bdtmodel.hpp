@@ -10,14 +10,12 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
 
-#include "boost_python.hpp"
-
 #include "dtmodel.hpp"
 #include "model.hpp"
 
+class Pruner;
 
 class BDTModel : public Model {
-    friend class BDTModel_pickle_suite;
 public:
 
     // structors
@@ -28,12 +26,6 @@ public:
 
     virtual ~BDTModel ();
 
-    // structors for Python
-
-    BDTModel (const boost::python::list& feature_names,
-              const boost::python::list& dtmodels,
-              const boost::python::list& alphas);
-
 
     // inspectors
 
@@ -44,24 +36,24 @@ public:
     std::vector<double> event_variable_importance (
         const Scoreable& s, bool sep_weighted, bool tree_weighted) const;
 
-    boost::python::dict event_variable_importance_py (
-        const boost::python::list& vals,
-        bool sep_weighted, bool tree_weighted) const;
-
     std::vector<double> variable_importance (
         bool sep_weighted, bool tree_weighted) const;
 
-    boost::python::dict variable_importance_py (
-        bool sep_weighted, bool tree_weighted) const;
-
     
     // helpers
 
     boost::shared_ptr<BDTModel> get_subset_bdtmodel (int n_i, int n_f) const;
     boost::shared_ptr<BDTModel> get_subset_bdtmodel_list (
-        boost::python::list dtmodel_indices) const;
+        const std::vector<int>& dtmodel_indices) const;
     boost::shared_ptr<BDTModel> get_trimmed_bdtmodel (double threshold) const;
 
+    // a new model whose trees are copies of these pruned by pruner, on up
+    // to num_threads threads (0: one per core); this model is unchanged.
+    // The built-in pruners keep no state while pruning, so one may be
+    // shared by all threads.
+    boost::shared_ptr<BDTModel> pruned (boost::shared_ptr<Pruner> pruner,
+                                        int num_threads) const;
+
 
 protected:
 
@@ -75,12 +67,4 @@ private:
     double m_max_response;
 };
 
-struct BDTModel_pickle_suite : boost::python::pickle_suite {
-    static
-    boost::python::tuple getinitargs (const BDTModel& m);
-};
-
-
-void export_bdtmodel ();
-
 #endif  /* PYBDT_BDTMODEL_HPP */
@@ -0,0 +1,480 @@
+// benchmark.cpp
+// throughput of the core training and scoring kernels
+//
+// Build against the core sources only with one command, e.g.
+//
+//   g++ -O2 -I.. benchmark.cpp ../*.cpp -o pybdt_benchmark
+//       -lboost_thread -lboost_system
+//
+// and run, again as one command,
+//
+//   pybdt_benchmark --n_events=100000 --n_features=10 --depth=5
+//       --min_time=0.5 --filter=trace --out=bench.json
+//
+// Results are written as JSON in the layout of Google Benchmark's
+// --benchmark_format=json, so existing tooling can compare releases.
+
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/ref.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "bdtlearner.hpp"
+#include "bdtmodel.hpp"
+#include "dataset.hpp"
+#include "dtlearner.hpp"
+#include "dtmodel.hpp"
+#include "linear_histogram.hpp"
+#include "nonlinear_histogram.hpp"
+#include "pruner.hpp"
+#include "random_sampler.hpp"
+#include "split_histogram.hpp"
+#include "training_log.hpp"
+
+
+using namespace std;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+
+
+namespace {
+
+// sizes of the synthetic problem
+struct Options {
+    int n_events;
+    int n_features;
+    int depth;
+    int num_trees;
+    double min_time;
+    string filter;
+    string out;
+};
+
+
+// Synthetic samples --------------------------------------------------
+
+vector<string>
+feature_names (int n_features)
+{
+    vector<string> names;
+    for (int j (0); j < n_features; ++j) {
+        ostringstream o;
+        o << "x" << j;
+        names.push_back (o.str ());
+    }
+    return names;
+}
+
+// Gaussian features of unit width; signal is shifted by shift / (j + 1)
+// in feature j, so the features range from strong to weak
+boost::shared_ptr<DataSet>
+make_sample (int n_events, int n_features, double shift, unsigned seed)
+{
+    boost::mt19937 rng (seed);
+    boost::variate_generator<boost::mt19937&, boost::normal_distribution<> >
+        normal (rng, boost::normal_distribution<> ());
+    vector<vector<double> > cols (n_features, vector<double> (n_events));
+    for (int j (0); j < n_features; ++j) {
+        const double mean (shift / (j + 1));
+        for (int i (0); i < n_events; ++i) {
+            cols[j][i] = mean + normal ();
+        }
+    }
+    return boost::make_shared<DataSet> (feature_names (n_features), cols);
+}
+
+vector<double>
+uniform_weights (int n)
+{
+    return vector<double> (n, 1. / n);
+}
+
+
+// Timing -------------------------------------------------------------
+
+// Handed to each benchmark; the benchmark runs its kernel iterations ()
+// times and may exclude setup with pause () and resume ().
+class State {
+public:
+
+    explicit State (long iterations)
+        : m_iterations (iterations), m_items (0), m_seconds (0),
+        m_start (microsec_clock::universal_time ())
+    { }
+
+    long iterations () const { return m_iterations; }
+    long items () const { return m_items; }
+    double seconds () const { return m_seconds; }
+
+    void add_items (long n) { m_items += n; }
+
+    void pause ()
+    {
+        m_seconds += elapsed ();
+    }
+
+    void resume ()
+    {
+        m_start = microsec_clock::universal_time ();
+    }
+
+    void stop ()
+    {
+        pause ();
+    }
+
+private:
+
+    double elapsed () const
+    {
+        return (microsec_clock::universal_time () - m_start)
+            .total_microseconds () / 1e6;
+    }
+
+    long m_iterations;
+    long m_items;
+    double m_seconds;
+    ptime m_start;
+
+};
+
+typedef boost::function<void (State&)> Kernel;
+
+struct Result {
+    string name;
+    long iterations;
+    double seconds;
+    long items;
+};
+
+// run kernel with growing iteration counts until it takes min_time
+Result
+run (const string& name, const Kernel& kernel, double min_time)
+{
+    long iterations (1);
+    for (;;) {
+        State state (iterations);
+        kernel (state);
+        state.stop ();
+        if (state.seconds () >= min_time or iterations >= 1000000000L) {
+            Result result = {
+                name, iterations, state.seconds (), state.items ()};
+            return result;
+        }
+        // aim past min_time, but grow by at most 10x per attempt
+        const double per_iteration (
+            state.seconds () > 0 ? state.seconds () / iterations : 0);
+        long next (10 * iterations);
+        if (per_iteration > 0) {
+            next = min (next, long (1.4 * min_time / per_iteration) + 1);
+        }
+        iterations = max (next, iterations + 1);
+    }
+}
+
+
+// Benchmarks ---------------------------------------------------------
+
+struct Fixture {
+    Options options;
+    vector<string> names;
+    boost::shared_ptr<DataSet> sig;
+    boost::shared_ptr<DataSet> bg;
+    vector<double> sig_weights;
+    vector<double> bg_weights;
+    boost::shared_ptr<DTLearner> dtlearner;
+    boost::shared_ptr<DTModel> dtmodel;
+    boost::shared_ptr<Model> bdtmodel;
+};
+
+void
+bench_build_tree (const Fixture& f, State& state)
+{
+    for (long i (0); i < state.iterations (); ++i) {
+        f.dtlearner->train_given_everything (
+            f.sig->events (), f.bg->events (), f.sig_weights, f.bg_weights);
+        state.add_items (f.sig->n_events () + f.bg->n_events ());
+    }
+}
+
+void
+bench_linear_fill (const Fixture& f, State& state)
+{
+    const vector<double> values (f.sig->get_column (f.names[0]));
+    for (long i (0); i < state.iterations (); ++i) {
+        LinearHistogram h (-5, 5, 21);
+        h.fill (values, f.sig_weights);
+        state.add_items (values.size ());
+    }
+}
+
+void
+bench_split_fill (const Fixture& f, State& state)
+{
+    for (long i (0); i < state.iterations (); ++i) {
+        SplitHistogram h (-5, 5, 21);
+        h.fill_sig (f.sig->events (), f.sig_weights, 0);
+        h.fill_bg (f.bg->events (), f.bg_weights, 0);
+        state.add_items (f.sig->n_events () + f.bg->n_events ());
+    }
+}
+
+void
+bench_ntile_boundaries (const Fixture& f, State& state)
+{
+    const pair<vector<double>,vector<double> > sorted (
+        NonlinearHistogram::get_pair_sorted_values_weights (
+            f.sig->get_column (f.names[0]), f.sig_weights));
+    for (long i (0); i < state.iterations (); ++i) {
+        NonlinearHistogram::get_ntile_boundaries (
+            20, sorted.first, sorted.second);
+        state.add_items (sorted.first.size ());
+    }
+}
+
+void
+bench_trace (const Fixture& f, State& state)
+{
+    const vector<Event>& events (f.sig->events ());
+    DTNode& root (*f.dtmodel->root ());
+    double sink (0);
+    for (long i (0); i < state.iterations (); ++i) {
+        for (vector<Event>::const_iterator i_ev = events.begin ();
+             i_ev != events.end (); ++i_ev) {
+            sink += root.trace (make_scoreable (*i_ev)).purity ();
+        }
+        state.add_items (events.size ());
+    }
+    if (sink < 0) {
+        cerr << sink;
+    }
+}
+
+void
+bench_bdt_score (const Fixture& f, State& state)
+{
+    for (long i (0); i < state.iterations (); ++i) {
+        f.bdtmodel->score (f.sig->events (), false, true);
+        state.add_items (f.sig->n_events ());
+    }
+}
+
+void
+bench_prune (const Fixture& f, boost::shared_ptr<Pruner> pruner,
+             State& state)
+{
+    for (long i (0); i < state.iterations (); ++i) {
+        state.pause ();
+        boost::shared_ptr<DTModel> copy (boost::make_shared<DTModel> (
+                f.names, f.dtmodel->root ()->get_copy ()));
+        state.resume ();
+        pruner->prune (copy);
+        state.add_items (f.dtmodel->root ()->tree_size ());
+    }
+}
+
+
+// Output -------------------------------------------------------------
+
+string
+json_escape (const string& s)
+{
+    string out;
+    for (size_t i (0); i < s.size (); ++i) {
+        if (s[i] == '"' or s[i] == '\\') {
+            out += '\\';
+        }
+        out += s[i];
+    }
+    return out;
+}
+
+void
+write_json (ostream& os, const Options& options,
+            const vector<Result>& results)
+{
+    os << "{\n  \"context\": {\n"
+        << "    \"executable\": \"pybdt_benchmark\",\n"
+        << "    \"n_events\": " << options.n_events << ",\n"
+        << "    \"n_features\": " << options.n_features << ",\n"
+        << "    \"depth\": " << options.depth << ",\n"
+        << "    \"num_trees\": " << options.num_trees << "\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i (0); i < results.size (); ++i) {
+        const Result& r (results[i]);
+        const double ns (1e9 * r.seconds / r.iterations);
+        os << (i ? "," : "") << "\n    {"
+            << "\"name\": \"" << json_escape (r.name) << "\", "
+            << "\"run_type\": \"iteration\", "
+            << "\"iterations\": " << r.iterations << ", "
+            << "\"real_time\": " << ns << ", "
+            << "\"time_unit\": \"ns\", "
+            << "\"items_per_second\": "
+            << (r.seconds > 0 ? r.items / r.seconds : 0) << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+// parse --key=value arguments into options
+Options
+parse_options (int argc, char** argv)
+{
+    Options options;
+    options.n_events = 100000;
+    options.n_features = 10;
+    options.depth = 5;
+    options.num_trees = 20;
+    options.min_time = 0.5;
+    for (int i (1); i < argc; ++i) {
+        const string arg (argv[i]);
+        const size_t eq (arg.find ('='));
+        if (arg.compare (0, 2, "--") != 0 or eq == string::npos) {
+            throw runtime_error ("expected --key=value, got \"" + arg + "\"");
+        }
+        const string key (arg.substr (2, eq - 2));
+        const string value (arg.substr (eq + 1));
+        if (key == "n_events") {
+            options.n_events = atoi (value.c_str ());
+        }
+        else if (key == "n_features") {
+            options.n_features = atoi (value.c_str ());
+        }
+        else if (key == "depth") {
+            options.depth = atoi (value.c_str ());
+        }
+        else if (key == "num_trees") {
+            options.num_trees = atoi (value.c_str ());
+        }
+        else if (key == "min_time") {
+            options.min_time = atof (value.c_str ());
+        }
+        else if (key == "filter") {
+            options.filter = value;
+        }
+        else if (key == "out") {
+            options.out = value;
+        }
+        else {
+            throw runtime_error ("unknown option \"" + key + "\"");
+        }
+    }
+    if (options.n_events < 2 or options.n_features < 1) {
+        throw runtime_error ("need n_events >= 2 and n_features >= 1");
+    }
+    return options;
+}
+
+}
+
+
+int
+main (int argc, char** argv)
+{
+    Options options;
+    try {
+        options = parse_options (argc, argv);
+    }
+    catch (const exception& e) {
+        cerr << e.what () << endl;
+        return 2;
+    }
+
+    Fixture f;
+    f.options = options;
+    f.names = feature_names (options.n_features);
+    f.sig = make_sample (options.n_events, options.n_features, 1., 1);
+    f.bg = make_sample (options.n_events, options.n_features, 0., 2);
+    f.sig_weights = uniform_weights (options.n_events);
+    f.bg_weights = uniform_weights (options.n_events);
+    f.dtlearner = boost::make_shared<DTLearner> (f.names);
+    f.dtlearner->max_depth (options.depth);
+    RandomSampler sampler (0);
+    f.dtmodel = f.dtlearner->train_given_config (
+        f.dtlearner->config (), sampler,
+        f.sig->events (), f.bg->events (), f.sig_weights, f.bg_weights);
+    BDTLearner bdtlearner (f.names);
+    bdtlearner.num_trees (options.num_trees);
+    bdtlearner.quiet (true);
+    bdtlearner.training_log ()->level (TrainingLog::NONE);
+    bdtlearner.dtlearner ()->max_depth (options.depth);
+    f.bdtmodel = bdtlearner.train_given_everything (
+        f.sig->events (), f.bg->events (), f.sig_weights, f.bg_weights);
+
+    ostringstream suffix;
+    suffix << "/n_events:" << options.n_events
+        << "/n_features:" << options.n_features
+        << "/depth:" << options.depth;
+    vector<pair<string, Kernel> > kernels;
+    kernels.push_back (make_pair (
+            "build_tree" + suffix.str (),
+            Kernel (boost::bind (&bench_build_tree, boost::cref (f), _1))));
+    kernels.push_back (make_pair (
+            "LinearHistogram::fill" + suffix.str (),
+            Kernel (boost::bind (&bench_linear_fill, boost::cref (f), _1))));
+    kernels.push_back (make_pair (
+            "SplitHistogram::fill" + suffix.str (),
+            Kernel (boost::bind (&bench_split_fill, boost::cref (f), _1))));
+    kernels.push_back (make_pair (
+            "NonlinearHistogram::get_ntile_boundaries" + suffix.str (),
+            Kernel (boost::bind (
+                    &bench_ntile_boundaries, boost::cref (f), _1))));
+    kernels.push_back (make_pair (
+            "DTNode::trace" + suffix.str (),
+            Kernel (boost::bind (&bench_trace, boost::cref (f), _1))));
+    kernels.push_back (make_pair (
+            "BDTModel::base_score" + suffix.str (),
+            Kernel (boost::bind (&bench_bdt_score, boost::cref (f), _1))));
+    kernels.push_back (make_pair (
+            "SameLeafPruner" + suffix.str (),
+            Kernel (boost::bind (
+                    &bench_prune, boost::cref (f),
+                    boost::shared_ptr<Pruner> (new SameLeafPruner ()), _1))));
+    kernels.push_back (make_pair (
+            "CostComplexityPruner" + suffix.str (),
+            Kernel (boost::bind (
+                    &bench_prune, boost::cref (f),
+                    boost::shared_ptr<Pruner> (
+                        new CostComplexityPruner (20)), _1))));
+    kernels.push_back (make_pair (
+            "ErrorPruner" + suffix.str (),
+            Kernel (boost::bind (
+                    &bench_prune, boost::cref (f),
+                    boost::shared_ptr<Pruner> (new ErrorPruner (2)), _1))));
+
+    vector<Result> results;
+    for (size_t i (0); i < kernels.size (); ++i) {
+        if (kernels[i].first.find (options.filter) == string::npos) {
+            continue;
+        }
+        cerr << kernels[i].first << "..." << endl;
+        results.push_back (
+            run (kernels[i].first, kernels[i].second, options.min_time));
+    }
+
+    if (options.out.size ()) {
+        ofstream os (options.out.c_str ());
+        write_json (os, options, results);
+        if (not os) {
+            cerr << "could not write \"" << options.out << "\"" << endl;
+            return 1;
+        }
+    }
+    else {
+        write_json (cout, options, results);
+    }
+    return 0;
+}
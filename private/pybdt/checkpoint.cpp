@@ -0,0 +1,237 @@
+// checkpoint.cpp
+
+#include "checkpoint.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+
+
+using namespace std;
+using namespace boost;
+
+
+namespace {
+
+const char magic[8] = {'P', 'Y', 'B', 'D', 'T', 'C', 'K', 'P'};
+// version 2 adds the leaf responses, version 3 the event scores
+const int32_t version = 3;
+
+template <typename T>
+void
+write_pod (ostream& os, const T& value)
+{
+    os.write (reinterpret_cast<const char*> (&value), sizeof (T));
+}
+
+template <typename T>
+T
+read_pod (istream& is)
+{
+    T value;
+    is.read (reinterpret_cast<char*> (&value), sizeof (T));
+    if (not is) {
+        throw runtime_error ("unexpected end of BDT checkpoint");
+    }
+    return value;
+}
+
+void
+write_string (ostream& os, const string& s)
+{
+    write_pod<uint64_t> (os, s.size ());
+    os.write (s.data (), s.size ());
+}
+
+string
+read_string (istream& is)
+{
+    const uint64_t n (read_pod<uint64_t> (is));
+    string s (n, '\0');
+    if (n) {
+        is.read (&s[0], n);
+    }
+    if (not is) {
+        throw runtime_error ("unexpected end of BDT checkpoint");
+    }
+    return s;
+}
+
+void
+write_doubles (ostream& os, const vector<double>& v)
+{
+    write_pod<uint64_t> (os, v.size ());
+    if (v.size ()) {
+        os.write (reinterpret_cast<const char*> (&v[0]),
+                  v.size () * sizeof (double));
+    }
+}
+
+vector<double>
+read_doubles (istream& is)
+{
+    const uint64_t n (read_pod<uint64_t> (is));
+    vector<double> v (n);
+    if (n) {
+        is.read (reinterpret_cast<char*> (&v[0]), n * sizeof (double));
+    }
+    if (not is) {
+        throw runtime_error ("unexpected end of BDT checkpoint");
+    }
+    return v;
+}
+
+}
+
+
+BDTCheckpoint::BDTCheckpoint ()
+{
+}
+
+int
+BDTCheckpoint::n_trees () const
+{
+    return roots.size ();
+}
+
+void
+BDTCheckpoint::save (const string& filename) const
+{
+    const string tmp_filename (filename + ".tmp");
+    {
+        ofstream os (tmp_filename.c_str (), ios::out | ios::binary);
+        if (not os) {
+            throw runtime_error (
+                "could not open \"" + tmp_filename + "\" for writing");
+        }
+        os.write (magic, sizeof (magic));
+        write_pod (os, version);
+        write_pod<uint64_t> (os, feature_names.size ());
+        for (size_t i (0); i < feature_names.size (); ++i) {
+            write_string (os, feature_names[i]);
+        }
+        write_pod<uint64_t> (os, roots.size ());
+        for (size_t i (0); i < roots.size (); ++i) {
+            write_node (os, *roots[i]);
+        }
+        write_doubles (os, errs);
+        write_doubles (os, alphas);
+        write_doubles (os, sig_weights);
+        write_doubles (os, bg_weights);
+        write_string (os, rng_state);
+        write_doubles (os, scores);
+        os.flush ();
+        if (not os) {
+            throw runtime_error ("could not write \"" + tmp_filename + "\"");
+        }
+    }
+    if (rename (tmp_filename.c_str (), filename.c_str ())) {
+        throw runtime_error (
+            "could not move \"" + tmp_filename + "\" to \"" + filename + "\"");
+    }
+}
+
+void
+BDTCheckpoint::load (const string& filename)
+{
+    ifstream is (filename.c_str (), ios::in | ios::binary);
+    if (not is) {
+        throw runtime_error ("could not open \"" + filename + "\"");
+    }
+    char file_magic[sizeof (magic)];
+    is.read (file_magic, sizeof (file_magic));
+    if (not is or not equal (magic, magic + sizeof (magic), file_magic)) {
+        throw runtime_error ("\"" + filename + "\" is not a BDT checkpoint");
+    }
+    const int32_t file_version (read_pod<int32_t> (is));
+    if (file_version < 1 or file_version > version) {
+        throw runtime_error (
+            "\"" + filename + "\" has an unsupported checkpoint version");
+    }
+    feature_names.resize (read_pod<uint64_t> (is));
+    for (size_t i (0); i < feature_names.size (); ++i) {
+        feature_names[i] = read_string (is);
+    }
+    roots.resize (read_pod<uint64_t> (is));
+    for (size_t i (0); i < roots.size (); ++i) {
+        roots[i] = read_node (is, file_version);
+    }
+    errs = read_doubles (is);
+    alphas = read_doubles (is);
+    sig_weights = read_doubles (is);
+    bg_weights = read_doubles (is);
+    rng_state = read_string (is);
+    scores = file_version >= 3 ? read_doubles (is) : vector<double> ();
+    if (errs.size () != roots.size () or alphas.size () != roots.size ()
+        or (scores.size ()
+            and scores.size () != sig_weights.size () + bg_weights.size ())) {
+        throw runtime_error ("\"" + filename + "\" is inconsistent");
+    }
+}
+
+void
+BDTCheckpoint::save_rng (const RandomSampler& sampler)
+{
+    ostringstream os (ios::out | ios::binary);
+    sampler.save_state (os);
+    rng_state = os.str ();
+}
+
+void
+BDTCheckpoint::load_rng (RandomSampler& sampler) const
+{
+    istringstream is (rng_state, ios::in | ios::binary);
+    sampler.load_state (is);
+}
+
+void
+BDTCheckpoint::write_node (ostream& os, const DTNode& node)
+{
+    // preorder; the cut of pruned nodes is kept, so that the restored tree
+    // is identical to the original
+    const bool is_leaf (node.is_leaf ());
+    write_pod<char> (os, is_leaf);
+    write_pod (os, node.sep_gain ());
+    write_pod (os, node.sep_index ());
+    write_pod<int32_t> (os, node.feature_id ());
+    write_pod (os, node.feature_val ());
+    write_pod (os, node.w_sig ());
+    write_pod (os, node.w_bg ());
+    write_pod<int32_t> (os, node.n_sig ());
+    write_pod<int32_t> (os, node.n_bg ());
+    write_pod (os, node.response ());
+    if (not is_leaf) {
+        write_node (os, *node.left ());
+        write_node (os, *node.right ());
+    }
+}
+
+boost::shared_ptr<DTNode>
+BDTCheckpoint::read_node (istream& is, int file_version)
+{
+    const bool is_leaf (read_pod<char> (is));
+    const double sep_gain (read_pod<double> (is));
+    const double sep_index (read_pod<double> (is));
+    const int feature_id (read_pod<int32_t> (is));
+    const double feature_val (read_pod<double> (is));
+    const double w_sig (read_pod<double> (is));
+    const double w_bg (read_pod<double> (is));
+    const int n_sig (read_pod<int32_t> (is));
+    const int n_bg (read_pod<int32_t> (is));
+    const double response (
+        file_version >= 2 ? read_pod<double> (is) : 0);
+    boost::shared_ptr<DTNode> left, right;
+    if (not is_leaf) {
+        left = read_node (is, file_version);
+        right = read_node (is, file_version);
+    }
+    boost::shared_ptr<DTNode> node (new DTNode (
+            sep_gain, sep_index, feature_id, feature_val,
+            w_sig, w_bg, n_sig, n_bg, left, right));
+    node->response (response);
+    return node;
+}
@@ -0,0 +1,55 @@
+// checkpoint.hpp
+// save and restore the state of a partially trained BDT
+
+
+#ifndef PYBDT_CHECKPOINT_HPP
+#define PYBDT_CHECKPOINT_HPP
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "dtmodel.hpp"
+#include "random_sampler.hpp"
+
+// Everything BDTLearner needs to continue boosting after tree n_trees ():
+// the trees so far, their errors and alphas, the current event weights and
+// scores and the random number generator state.
+struct BDTCheckpoint {
+
+    BDTCheckpoint ();
+
+    int n_trees () const;
+
+    // binary file I/O; save () writes to a temporary file and renames it,
+    // so an interrupted save never clobbers the previous checkpoint
+    void save (const std::string& filename) const;
+    void load (const std::string& filename);
+
+    // copy generator state between a RandomSampler and this checkpoint
+    void save_rng (const RandomSampler& sampler);
+    void load_rng (RandomSampler& sampler) const;
+
+    std::vector<std::string> feature_names;
+    std::vector<boost::shared_ptr<DTNode> > roots;
+    std::vector<double> errs;
+    std::vector<double> alphas;
+    std::vector<double> sig_weights;
+    std::vector<double> bg_weights;
+    std::string rng_state;
+    // the boosting score of every event, signal first; empty when read
+    // from a file older than version 3
+    std::vector<double> scores;
+
+private:
+
+    static void write_node (std::ostream& os, const DTNode& node);
+    static boost::shared_ptr<DTNode> read_node (std::istream& is,
+                                                int file_version);
+
+};
+
+
+#endif  /* PYBDT_CHECKPOINT_HPP */
@@ -6,18 +6,10 @@
 #include "np.hpp"
 
 #include <cmath>
-
-#include <boost/make_shared.hpp>
-
-#define PY_ARRAY_UNIQUE_SYMBOL pybdt_ARRAY_API
-#define NO_IMPORT_ARRY
-#include <numpy/ndarrayobject.h>
+#include <stdexcept>
 
 
 using namespace std;
-using namespace boost;
-using namespace boost::python;
-namespace py = boost::python;
 
 
 // Event ------------------------------------------------------------
@@ -37,73 +29,51 @@ Event::operator= (const Event& e)
 
 // DataSet ----------------------------------------------------------
 
-DataSet::DataSet (const py::dict& data, string subset)
-: m_n_features (0), m_n_events (0), m_livetime (-1)
+DataSet::DataSet (const vector<string>& names,
+                  const vector<vector<double> >& cols,
+                  double livetime, const string& subset)
+: m_names (names), m_n_features (names.size ()), m_n_events (0),
+    m_livetime (livetime)
 {
-    // data should be a dict of (str, numpy.ndarray) items
-    int n_input_cols (len (data));
-    py::list keys = data.keys ();
-    keys.sort ();
-    vector<vector<double> > cols;
-    // get data into vectors
-    for (int j = 0; j < n_input_cols; ++j) {
-        string name = extract<string> (keys[j]);
-        if (name == "livetime") {
-            m_livetime = extract<double> (data[name]);
-            continue;
-        }
-        py::object pycol = data[name];
-        PyObject* C_numpy_col = pycol.ptr ();
-        if (not PyArray_Check (C_numpy_col)) {
-            continue;
-        }
-        m_names.push_back (name);
-        // n.b.: C_numpy_col had better consist of floats!
-        // (pure-Python wrapper layer ensures this)
-        cols.push_back (np::array_to_vector<double> (C_numpy_col));
+    if (cols.size () != names.size ()) {
+        throw runtime_error ("DataSet needs one column per name");
+    }
+    if (m_n_features) {
+        m_n_events = cols[0].size ();
     }
-    m_n_features = cols.size ();
-    m_n_events = cols[0].size ();
     // check for matching column lengths
     for (int i_col (1); i_col < m_n_features; ++i_col) {
         if (int (cols[i_col].size ()) != m_n_events) {
             throw runtime_error (
-                "column " + m_names[i_col] + "had non-matching length");
+                "column " + m_names[i_col] + " had non-matching length");
         }
     }
+    if ((subset != "even") and (subset != "odd")) {
+        m_cols = cols;
+        m_events.reserve (m_n_events);
+        for (int i_row (0); i_row < m_n_events; ++i_row) {
+            m_events.push_back (Event (this, i_row));
+        }
+        return;
+    }
     // set up permanent columns, events
     m_cols.resize (m_n_features);
-    int n_reserve;
-    if ((subset == "even") or (subset == "odd")) {
-        n_reserve = m_n_events / 2 + 2;
-    }
-    else {
-        n_reserve = m_n_events;
-    }
+    const int n_reserve (m_n_events / 2 + 2);
     for (int i_col (0); i_col < m_n_features; ++i_col) {
         m_cols[i_col].reserve (n_reserve);
     }
     m_events.reserve (n_reserve);
     int i_row_kept (0);
-    for (int i_row (0); i_row < m_n_events; ++i_row) {
-        if ((subset == "even") and (i_row % 2 == 1)) {
-            continue;
-        }
-        if ((subset == "odd") and (i_row % 2 == 0)) {
-            continue;
-        }
+    for (int i_row (subset == "odd" ? 1 : 0); i_row < m_n_events; i_row += 2) {
         for (int j_col (0); j_col < m_n_features; ++j_col) {
             m_cols[j_col].push_back (cols[j_col][i_row]);
         }
         m_events.push_back (Event (this, i_row_kept));
         i_row_kept += 1;
     }
-    if ((subset == "even") or (subset == "odd")) {
-        m_n_events = m_events.size ();
-    }
+    m_n_events = m_events.size ();
 }
 
-
 DataSet::DataSet (const DataSet& other,
                   const vector<string>& names)
 : m_names (names), m_n_features (names.size ()), m_livetime (other.m_livetime)
@@ -171,67 +141,8 @@ DataSet::get_column_indices (
     return out;
 }
 
-PyObject*
-DataSet::getitem (const string& name) const
-{
-    return np::vector_to_array (get_column (name));
-}
-
-inline double
-DataSet::livetime () const
-{
-    return m_livetime;
-}
-
 vector<string>
 DataSet::names () const
 {
     return m_names;
 }
-
-py::list
-DataSet::names_py () const
-{
-    return np::vector_to_list (m_names);
-}
-
-py::dict
-DataSet::to_dict () const
-{
-    dict out;
-    for (vector<string>::const_iterator i_name = m_names.begin ();
-         i_name != m_names.end (); ++i_name) {
-        out[*i_name] = object (handle<> (borrowed (getitem (*i_name))));
-    }
-    return out;
-}
-
-inline void
-DataSet::livetime (const double t)
-{
-    m_livetime = t;
-}
-
-
-void
-export_dataset ()
-{
-
-    class_<DataSet> (
-        "DataSet",
-         init<py::dict> ())
-        .def (init<py::dict,string> ())
-        .def ("get_column", &DataSet::get_column)
-        .def ("to_dict", &DataSet::to_dict)
-        .def ("__getitem__", &DataSet::getitem)
-        .def ("__len__", &DataSet::n_events)
-        .add_property ("n_features", &DataSet::n_features)
-        .add_property ("n_events", &DataSet::n_events)
-        .add_property ("names", &DataSet::names_py)
-        .add_property (
-            "livetime",
-            (double (DataSet::*)()const) &DataSet::livetime,
-            (void (DataSet::*)(double)) &DataSet::livetime)
-        // .def_pickle (DataSet_pickle_suite ())
-        ;
-}
@@ -9,8 +9,6 @@
 #include <vector>
 #include <string>
 
-#include "boost_python.hpp"
-
 class DataSet;
 
 class Event {
@@ -42,8 +40,12 @@ public:
 
     // structors
 
-    explicit DataSet (const boost::python::dict& data,
-                      const std::string subset="all");
+    // cols[j] holds the values of the column names[j]; subset "even" or
+    // "odd" keeps only the rows with even or odd index
+    DataSet (const std::vector<std::string>& names,
+             const std::vector<std::vector<double> >& cols,
+             double livetime=-1,
+             const std::string& subset="all");
 
     DataSet (const DataSet& other,
              const std::vector<std::string>& names);
@@ -58,23 +60,15 @@ public:
     int get_column_index (const std::string& name) const;
     std::vector<int> get_column_indices (
         const std::vector<std::string>& feature_names) const;
-    PyObject* getitem (const std::string& name) const;
 
     double livetime () const;
 
     std::vector<std::string> names () const;
-    boost::python::list names_py () const;
 
     int n_features () const;
     int n_events () const;
 
 
-
-    // conversions
-
-    boost::python::dict to_dict () const;
-
-
     // mutators
 
     void livetime (const double t);
@@ -93,9 +87,6 @@ protected:
 };
 
 
-void export_dataset ();
-
-
 
 inline double
 Event::operator[] (const size_type index) const
@@ -168,5 +159,17 @@ DataSet::n_events () const
     return m_n_events;
 }
 
+inline double
+DataSet::livetime () const
+{
+    return m_livetime;
+}
+
+inline void
+DataSet::livetime (const double t)
+{
+    m_livetime = t;
+}
+
 
 #endif  /* PYBDT_DATASET_HPP */
@@ -1,13 +1,12 @@
 // dtlearner.cpp
 
-#include <Python.h>
-
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include "dtlearner.hpp"
 
 #include "linear_histogram.hpp"
 #include "nonlinear_histogram.hpp"
+#include "split_histogram.hpp"
 #include "np.hpp"
 
 #include <limits>
@@ -16,7 +15,6 @@
 
 using namespace std;
 using namespace boost;
-namespace py = boost::python;
 
 
 DTLearner::DTLearner (const vector<string>& feature_names,
@@ -38,28 +36,6 @@ DTLearner::~DTLearner ()
 {
 }
 
-DTLearner::DTLearner (const py::list& feature_names,
-                      const string& weight_name)
-: Learner (feature_names, weight_name)
-{
-    set_defaults ();
-}
-
-DTLearner::DTLearner (
-    const py::list& feature_names,
-    const string& sig_weight_name,
-    const string& bg_weight_name)
-: Learner (feature_names, sig_weight_name, bg_weight_name)
-{
-    int n_names = len (feature_names);
-    m_feature_names.resize (n_names);
-    for (int j = 0; j < n_names; ++j) {
-        string name = py::extract<string> (feature_names[j]);
-        m_feature_names[j] = name;
-    }
-    set_defaults ();
-}
-
 
 int
 DTLearner::max_depth () const
@@ -91,12 +67,44 @@ DTLearner::num_random_variables () const
     return m_num_random_variables;
 }
 
+boost::shared_ptr<TrainingProfile>
+DTLearner::profile () const
+{
+    return m_profile;
+}
+
+bool
+DTLearner::profiling () const
+{
+    return bool (m_profile);
+}
+
+int
+DTLearner::seed () const
+{
+    return m_seed;
+}
+
 std::string
 DTLearner::separation_type () const
 {
     return m_sep_func->separation_type ();
 }
 
+DTConfig
+DTLearner::config () const
+{
+    DTConfig out;
+    out.sep_func = m_sep_func;
+    out.min_split = m_min_split;
+    out.max_depth = m_max_depth;
+    out.num_cuts = m_num_cuts;
+    out.linear_cuts = m_linear_cuts;
+    out.num_random_variables = m_num_random_variables;
+    out.profile = m_profile;
+    return out;
+}
+
 void
 DTLearner::max_depth (int n)
 {
@@ -121,26 +129,50 @@ DTLearner::linear_cuts (bool value)
     m_linear_cuts = value;
 }
 
+void
+DTLearner::profiling (bool value)
+{
+    // enabling again keeps the totals so far
+    if (value and not m_profile) {
+        m_profile = boost::make_shared<TrainingProfile> ();
+    }
+    else if (not value) {
+        m_profile.reset ();
+    }
+}
+
 void
 DTLearner::num_random_variables (int n)
 {
     m_num_random_variables = n;
 }
 
+void
+DTLearner::seed (int n)
+{
+    m_seed = n;
+}
+
 void
 DTLearner::separation_type (std::string st)
+{
+    m_sep_func = make_sep_func (st);
+}
+
+boost::shared_ptr<SepFunc>
+DTLearner::make_sep_func (const std::string& st)
 {
     if (st == "gini") {
-        m_sep_func = boost::make_shared<SepGini> ();
+        return boost::make_shared<SepGini> ();
     }
     else if (st == "cross_entropy") {
-        m_sep_func = boost::make_shared<SepCrossEntropy> ();
+        return boost::make_shared<SepCrossEntropy> ();
     }
     else if (st == "misclass_error") {
-        m_sep_func = boost::make_shared<SepMisclassError> ();
+        return boost::make_shared<SepMisclassError> ();
     }
     else if (st == "sum_squared") {
-        m_sep_func = boost::make_shared<SumSquaredError> ();
+        return boost::make_shared<SumSquaredError> ();
     }
     else {
         throw std::runtime_error ("unknown separation type");
@@ -156,6 +188,7 @@ DTLearner::set_defaults ()
     m_max_depth = 5;
     m_num_cuts = 20;
     m_num_random_variables = 0;
+    m_seed = 0;
 }
 
 RegLearner::RegLearner (const vector<string>& feature_names,
@@ -166,15 +199,6 @@ RegLearner::RegLearner (const vector<string>& feature_names,
     separation_type ("sum_squared");
 }
 
-RegLearner::RegLearner (
-    const py::list& feature_names,
-    const string& sig_weight_name,
-    const string& bg_weight_name)
-: DTLearner (feature_names, sig_weight_name, bg_weight_name)
-{
-    separation_type ("cross_entropy");
-}
-
 RegLearner::~RegLearner ()
 {
 }
@@ -183,17 +207,42 @@ boost::shared_ptr<Model>
 DTLearner::train_given_everything (const vector<Event>& sig,
                                    const vector<Event>& bg,
                                    const vector<double>& sig_weights,
-                                   const vector<double>& bg_weights) const
+                                   const vector<double>& bg_weights,
+                                   TrainingStatus* status) const
+{
+    assert (sig.size () == sig_weights.size ());
+    assert (bg.size () == bg_weights.size ());
+    if (status) {
+        status->check ();
+    }
+    RandomSampler sampler (m_seed);
+    boost::shared_ptr<DTModel> model (train_given_config (
+            config (), sampler, sig, bg, sig_weights, bg_weights));
+    if (status) {
+        status->progress (1);
+    }
+    return model;
+}
+
+boost::shared_ptr<DTModel>
+DTLearner::train_given_config (const DTConfig& config,
+                               RandomSampler& sampler,
+                               const vector<Event>& sig,
+                               const vector<Event>& bg,
+                               const vector<double>& sig_weights,
+                               const vector<double>& bg_weights) const
 {
     assert (sig.size () == sig_weights.size ());
     assert (bg.size () == bg_weights.size ());
     boost::shared_ptr<DTNode> root = build_tree (
+        config, config.sep_func->split_scan (), sampler,
         sig, bg, sig_weights, bg_weights);
     return boost::make_shared<DTModel> (m_feature_names, root);
 }
 
 boost::shared_ptr<DTNode>
 DTLearner::build_tree (
+    const DTConfig& config, SplitScanFunc scan, RandomSampler& sampler,
     const vector<Event>& sig_events,
     const vector<Event>& bg_events,
     const vector<double>& sig_weights, const vector<double>& bg_weights,
@@ -212,17 +261,19 @@ DTLearner::build_tree (
     double w_bg (np::sum (bg_weights));
     const double w_here (w_sig + w_bg);
     const double purity_here (w_sig / w_here);
-    const double sep_here ((*m_sep_func) (purity_here));
+    const double sep_here ((*config.sep_func) (purity_here));
+    TrainingProfile* const profile (config.profile.get ());
 
     // if too few events, max depth, or all one type, then make leaf now
-    if ((n_sig + n_bg < m_min_split)
-        or depth == m_max_depth or n_sig == 0 or n_bg == 0) {
+    if ((n_sig + n_bg < config.min_split)
+        or depth == config.max_depth or n_sig == 0 or n_bg == 0) {
         return boost::make_shared<DTNode> (sep_here, w_sig, w_bg, n_sig, n_bg);
     }
 
     const int n_available_features (m_feature_names.size ());
     const int n_split_features (
-        m_num_random_variables ? m_num_random_variables : n_available_features);
+        config.num_random_variables
+        ? config.num_random_variables : n_available_features);
 
     // get indices of features in m_feature_names
     vector<int> split_features_i;
@@ -230,7 +281,7 @@ DTLearner::build_tree (
         split_features_i = np::range<int> (n_available_features);
     }
     else {
-        split_features_i = m_random_sampler.sample_range<int> (
+        split_features_i = sampler.sample_range<int> (
             n_split_features, 0, n_available_features);
     }
 
@@ -249,6 +300,7 @@ DTLearner::build_tree (
     // get extreme values of features
     vector<double> feature_mins (n_split_features);
     vector<double> feature_maxs (n_split_features);
+    ProfileScope minmax_scope (profile, "minmax", n_sig + n_bg);
     for (i_ev = sig_events.begin ();
          i_ev != sig_events.end (); ++i_ev) {
         for (int i_i_f (0); i_i_f < n_split_features; ++i_i_f) {
@@ -284,15 +336,33 @@ DTLearner::build_tree (
     // all_weights.insert (
     //     all_weights.end (), bg_weights.begin (), bg_weights.end ());
 
-    // create sig and bg, weighted and unweighted histogram for each feature
+    // create sig and bg, weighted and unweighted histogram for each feature:
+    // with linear cuts, one SplitHistogram holds all four
+    vector<SplitHistogram> split_hists;
     vector<boost::shared_ptr<Histogram> > w_sig_hists;
     vector<boost::shared_ptr<Histogram> > w_bg_hists;
     vector<boost::shared_ptr<Histogram> > n_sig_hists;
     vector<boost::shared_ptr<Histogram> > n_bg_hists;
+    minmax_scope.stop ();
+    if (config.linear_cuts) {
+        split_hists.reserve (n_split_features);
+    }
     for (int i_i_f (0); i_i_f < n_split_features; ++i_i_f) {
+        ProfileScope histogram_scope (
+            profile, "histogram", n_sig + n_bg,
+            4 * (config.num_cuts + 1) * sizeof (double));
+        const int i_f (split_features_i[i_i_f]);
+        if (config.linear_cuts) {
+            split_hists.push_back (SplitHistogram (
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
+            split_hists.back ().fill_sig (sig_events, sig_weights, i_f);
+            split_hists.back ().fill_bg (bg_events, bg_weights, i_f);
+            continue;
+        }
+        histogram_scope.add_est_bytes ((n_sig + n_bg) * sizeof (double));
         // get values and weights lists
         //cerr << "variable " << i_i_f << endl;
-        const int i_f (split_features_i[i_i_f]);
         vecd sig_values;
         for (i_ev = sig_events.begin (); i_ev != sig_events.end (); ++i_ev) {
             const double value = i_ev->value (i_f);
@@ -304,66 +374,54 @@ DTLearner::build_tree (
             bg_values.push_back (value);
         }
         boost::shared_ptr<NonlinearHistogram> h;
-        if (m_linear_cuts) {
-	  w_sig_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
-	  w_bg_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
-	  n_sig_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
-	  n_bg_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
-            w_sig_hists[i_i_f]->fill (sig_values, sig_weights);
-            n_sig_hists[i_i_f]->fill (sig_values);
-            w_bg_hists[i_i_f]->fill (bg_values, bg_weights);
-            n_bg_hists[i_i_f]->fill (bg_values);
-        }
-        else {
-            pair<vecd,vecd> sig_sorted_values_weights_pair (
-                NonlinearHistogram::get_pair_sorted_values_weights (
-                    sig_values, sig_weights));
-            vecd sig_sorted_values (sig_sorted_values_weights_pair.first);
-            vecd sig_sorted_weights (sig_sorted_values_weights_pair.second);
-
-            pair<vecd,vecd> bg_sorted_values_weights_pair (
-                NonlinearHistogram::get_pair_sorted_values_weights (
-                    bg_values, bg_weights));
-            vecd bg_sorted_values (bg_sorted_values_weights_pair.first);
-            vecd bg_sorted_weights (bg_sorted_values_weights_pair.second);
-
-            vecd all_values (sig_sorted_values);
-            all_values.insert (
-                all_values.end (),
-                bg_sorted_values.begin (), bg_sorted_values.end ());
-
-            vecd all_sorted_weights (sig_sorted_weights);
-            all_sorted_weights.insert (
-                all_sorted_weights.end (),
-                bg_sorted_weights.begin (), bg_sorted_weights.end ());
-
-            vecd bin_edges (NonlinearHistogram::get_ntile_boundaries (
-                    m_num_cuts, all_values, all_sorted_weights));
-
-            h = boost::make_shared<NonlinearHistogram> (bin_edges);
-            h->fill_presorted (sig_sorted_values, sig_sorted_weights);
-            w_sig_hists.push_back (h);
-
-            h = boost::make_shared<NonlinearHistogram> (bin_edges);
-            h->fill_presorted (bg_sorted_values, bg_sorted_weights);
-            w_bg_hists.push_back (h);
-
-            h = boost::make_shared<NonlinearHistogram> (bin_edges);
-            h->fill_presorted (
-                sig_sorted_values,
-                np::ones<double> (sig_sorted_values.size ()));
-            n_sig_hists.push_back (h);
-
-            h = boost::make_shared<NonlinearHistogram> (bin_edges);
-            h->fill_presorted (
-                bg_sorted_values,
-                np::ones<double> (bg_sorted_values.size ()));
-            n_bg_hists.push_back (h);
-        }
+        ProfileScope sort_scope (
+            profile, "sort", n_sig + n_bg,
+            4 * (n_sig + n_bg) * sizeof (double));
+        pair<vecd,vecd> sig_sorted_values_weights_pair (
+            NonlinearHistogram::get_pair_sorted_values_weights (
+                sig_values, sig_weights));
+        vecd sig_sorted_values (sig_sorted_values_weights_pair.first);
+        vecd sig_sorted_weights (sig_sorted_values_weights_pair.second);
+
+        pair<vecd,vecd> bg_sorted_values_weights_pair (
+            NonlinearHistogram::get_pair_sorted_values_weights (
+                bg_values, bg_weights));
+        vecd bg_sorted_values (bg_sorted_values_weights_pair.first);
+        vecd bg_sorted_weights (bg_sorted_values_weights_pair.second);
+
+        vecd all_values (sig_sorted_values);
+        all_values.insert (
+            all_values.end (),
+            bg_sorted_values.begin (), bg_sorted_values.end ());
+
+        vecd all_sorted_weights (sig_sorted_weights);
+        all_sorted_weights.insert (
+            all_sorted_weights.end (),
+            bg_sorted_weights.begin (), bg_sorted_weights.end ());
+
+        vecd bin_edges (NonlinearHistogram::get_ntile_boundaries (
+                config.num_cuts, all_values, all_sorted_weights));
+        sort_scope.stop ();
+
+        h = boost::make_shared<NonlinearHistogram> (bin_edges);
+        h->fill_presorted (sig_sorted_values, sig_sorted_weights);
+        w_sig_hists.push_back (h);
+
+        h = boost::make_shared<NonlinearHistogram> (bin_edges);
+        h->fill_presorted (bg_sorted_values, bg_sorted_weights);
+        w_bg_hists.push_back (h);
+
+        h = boost::make_shared<NonlinearHistogram> (bin_edges);
+        h->fill_presorted (
+            sig_sorted_values,
+            np::ones<double> (sig_sorted_values.size ()));
+        n_sig_hists.push_back (h);
+
+        h = boost::make_shared<NonlinearHistogram> (bin_edges);
+        h->fill_presorted (
+            bg_sorted_values,
+            np::ones<double> (bg_sorted_values.size ()));
+        n_bg_hists.push_back (h);
     }
 
     // scan each pair (sig,bg) of histograms for best separation gain
@@ -371,76 +429,53 @@ DTLearner::build_tree (
     double best_sep_index (-1);
     int best_i_f (-1);
     double best_cut_val (numeric_limits<double>::quiet_NaN ());
+    ProfileScope scan_scope (profile, "split_scan");
+    SplitScan split;
+    split.w_sig_total = w_sig;
+    split.w_bg_total = w_bg;
+    split.n_sig_total = n_sig;
+    split.n_bg_total = n_bg;
+    split.sep_here = sep_here;
+    split.min_split = config.min_split;
+    split.best_gain = best_sep_gain;
     for (int i_i_f (0); i_i_f < n_split_features; ++i_i_f) {
-        int i_f (split_features_i[i_i_f]);
-        const Histogram& w_h_sig = *w_sig_hists[i_i_f];
-        const Histogram& w_h_bg = *w_bg_hists[i_i_f];
-        const Histogram& n_h_sig = *n_sig_hists[i_i_f];
-        const Histogram& n_h_bg = *n_bg_hists[i_i_f];
-        double w_sig_left (0), w_sig_right (w_sig);
-        double w_bg_left (0), w_bg_right (w_bg);
-        double n_sig_left (0), n_sig_right (n_sig);
-        double n_bg_left (0), n_bg_right (n_bg);
-        // cut is at right edge of bin -- don't bother checking last bin
-        vecd_citer i_w_h_sig (w_h_sig.begin ());
-        vecd_citer i_n_h_sig (n_h_sig.begin ());
-        vecd_citer i_w_h_bg (w_h_bg.begin ());
-        vecd_citer i_n_h_bg (n_h_bg.begin ());
-        int i_bin (0);
-        const int n_bins (w_h_sig.n_bins ());
-        for (; i_bin < n_bins - 1;
-             ++i_bin, ++i_w_h_sig, ++i_n_h_sig, ++i_w_h_bg, ++i_n_h_bg) {
-             w_sig_left += *i_w_h_sig;
-             w_bg_left += *i_w_h_bg;
-             n_sig_left += *i_n_h_sig;
-             n_bg_left += *i_n_h_bg;
-             w_sig_right -= *i_w_h_sig;
-             w_bg_right -= *i_w_h_bg;
-             n_sig_right -= *i_n_h_sig;
-             n_bg_right -= *i_n_h_bg;
-            const double n_left = n_sig_left + n_bg_left;
-            const double n_right = n_sig_right + n_bg_right;
-            if (n_left < m_min_split) {
-                continue; // not enough to the left yet
-            }
-            if (n_right < m_min_split) {
-                break; // not enough remaining to the right anymore
-            }
-            const double w_left = w_sig_left + w_bg_left;
-            const double w_right = w_sig_right + w_bg_right;
-            if (w_left <= 0) {
-                // cerr << endl << "w_left = " << w_left
-                //     << ", yet n_left = " << n_left;
-                // cerr << endl << "w_sig_left = " << w_sig_left
-                //     << " and w_bg_left = " << w_bg_left;
-                // cerr << endl << "w_sig_right = " << w_sig_right
-                //     << " and w_bg_right = " << w_bg_right;
-            }
-            if (w_right <= 0) {
-                // cerr << endl << "w_right = " << w_right
-                //     << ", yet n_right = " << n_right;
-                // cerr << endl << "w_sig_left = " << w_sig_left
-                //     << " and w_bg_left = " << w_bg_left;
-                // cerr << endl << "w_sig_right = " << w_sig_right
-                //     << " and w_bg_right = " << w_bg_right;
-            }
-            const double purity_left = w_sig_left / w_left;
-            const double purity_right = w_sig_right / w_right;
-            const double sep_left = (*m_sep_func) (purity_left);
-            const double sep_right = (*m_sep_func) (purity_right);
-            const double sep_gain = w_here * sep_here
-                - (w_left * sep_left) - (w_right * sep_right);
-            if (sep_gain > best_sep_gain) {
-                best_sep_gain = sep_gain;
-                best_sep_index = sep_here;
-                best_i_f = i_f;
-                best_cut_val = w_h_sig.value_for_index (i_bin + 1);
-            }
+        if (config.linear_cuts) {
+            const SplitHistogram& h = split_hists[i_i_f];
+            split.w_sig = h.bins () + SplitHistogram::W_SIG;
+            split.w_bg = h.bins () + SplitHistogram::W_BG;
+            split.n_sig = h.bins () + SplitHistogram::N_SIG;
+            split.n_bg = h.bins () + SplitHistogram::N_BG;
+            split.stride = SplitHistogram::N_SUMS;
+            split.n_bins = h.n_bins ();
+        }
+        else {
+            const Histogram& w_h_sig = *w_sig_hists[i_i_f];
+            split.w_sig = &*w_h_sig.begin ();
+            split.w_bg = &*w_bg_hists[i_i_f]->begin ();
+            split.n_sig = &*n_sig_hists[i_i_f]->begin ();
+            split.n_bg = &*n_bg_hists[i_i_f]->begin ();
+            split.stride = 1;
+            split.n_bins = w_h_sig.n_bins ();
+        }
+        split.best_bin = -1;
+        scan (*config.sep_func, split);
+        if (split.best_bin >= 0) {
+            best_sep_gain = split.best_gain;
+            best_sep_index = sep_here;
+            best_i_f = split_features_i[i_i_f];
+            best_cut_val = config.linear_cuts
+                ? split_hists[i_i_f].value_for_index (split.best_bin + 1)
+                : w_sig_hists[i_i_f]->value_for_index (split.best_bin + 1);
         }
     }
 
+    scan_scope.stop ();
+
     // use chosen split
     if (best_i_f >= 0) {
+        ProfileScope partition_scope (
+            profile, "partition", n_sig + n_bg,
+            2 * (n_sig + n_bg) * (sizeof (Event) + sizeof (double)));
         //cerr << setw (depth) << ' '
         //    << "cutting on " << m_feature_names[best_i_f]
         //    << " at " << best_cut_val
@@ -490,11 +525,15 @@ DTLearner::build_tree (
             }
         }
 
+        partition_scope.stop ();
+
         boost::shared_ptr<DTNode> left (build_tree (
+                config, scan, sampler,
                 sig_left, bg_left,
                 sig_weights_left, bg_weights_left,
                 depth + 1));
         boost::shared_ptr<DTNode> right (build_tree (
+                config, scan, sampler,
                 sig_right, bg_right,
                 sig_weights_right, bg_weights_right,
                 depth + 1));
@@ -507,8 +546,229 @@ DTLearner::build_tree (
     return boost::make_shared<DTNode> (sep_here, w_sig, w_bg, n_sig, n_bg);
 }
 
+boost::shared_ptr<DTModel>
+DTLearner::train_given_gradients (const DTConfig& config,
+                                  RandomSampler& sampler,
+                                  const vector<Event>& sig,
+                                  const vector<Event>& bg,
+                                  const vector<double>& sig_weights,
+                                  const vector<double>& bg_weights,
+                                  const vector<double>& sig_g,
+                                  const vector<double>& sig_h,
+                                  const vector<double>& bg_g,
+                                  const vector<double>& bg_h,
+                                  double learning_rate, double l2) const
+{
+    assert (sig.size () == sig_g.size () and sig.size () == sig_h.size ());
+    assert (bg.size () == bg_g.size () and bg.size () == bg_h.size ());
+    // nonlinear bins of equal hessian are found once per tree, from one
+    // sort of each feature's values, rather than at every node
+    vector<vector<double> > bin_edges;
+    if (not config.linear_cuts and sig.size () + bg.size ()) {
+        const int n_features (m_feature_names.size ());
+        // h and values, plus about ten copies of a column per feature
+        // within get_ntile_boundaries
+        ProfileScope sort_scope (
+            config.profile.get (), "sort", sig.size () + bg.size (),
+            (sig.size () + bg.size ()) * (2 + 10 * n_features)
+            * sizeof (double));
+        vector<double> h (sig_h);
+        h.insert (h.end (), bg_h.begin (), bg_h.end ());
+        vector<double> values;
+        values.reserve (h.size ());
+        bin_edges.resize (n_features);
+        for (int i_f (0); i_f < n_features; ++i_f) {
+            values.clear ();
+            for (size_t i (0); i < sig.size (); ++i) {
+                values.push_back (sig[i].value (i_f));
+            }
+            for (size_t i (0); i < bg.size (); ++i) {
+                values.push_back (bg[i].value (i_f));
+            }
+            bin_edges[i_f] = NonlinearHistogram::get_ntile_boundaries (
+                config.num_cuts, values, h);
+        }
+    }
+    boost::shared_ptr<DTNode> root = build_newton_tree (
+        config, sampler, sig, bg, sig_weights, bg_weights,
+        sig_g, sig_h, bg_g, bg_h, learning_rate, l2, bin_edges);
+    return boost::make_shared<DTModel> (m_feature_names, root);
+}
+
+boost::shared_ptr<DTNode>
+DTLearner::build_newton_tree (
+    const DTConfig& config, RandomSampler& sampler,
+    const vector<Event>& sig_events,
+    const vector<Event>& bg_events,
+    const vector<double>& sig_weights, const vector<double>& bg_weights,
+    const vector<double>& sig_g, const vector<double>& sig_h,
+    const vector<double>& bg_g, const vector<double>& bg_h,
+    double learning_rate, double l2,
+    const vector<vector<double> >& bin_edges,
+    const int depth) const
+{
+    typedef vector<Event> vecev;
+    typedef vector<double> vecd;
+
+    const int n_sig (sig_events.size ());
+    const int n_bg (bg_events.size ());
+    const double w_sig (np::sum (sig_weights));
+    const double w_bg (np::sum (bg_weights));
+    const double g_here (np::sum (sig_g) + np::sum (bg_g));
+    const double h_here (np::sum (sig_h) + np::sum (bg_h));
+    const double score_here (g_here * g_here / (h_here + l2));
+    TrainingProfile* const profile (config.profile.get ());
+
+    boost::shared_ptr<DTNode> leaf (
+        boost::make_shared<DTNode> (score_here, w_sig, w_bg, n_sig, n_bg));
+    leaf->response (-learning_rate * g_here / (h_here + l2));
+
+    // if too few events or max depth, then make leaf now
+    if (n_sig + n_bg < config.min_split or depth == config.max_depth) {
+        return leaf;
+    }
+
+    const int n_available_features (m_feature_names.size ());
+    const int n_split_features (
+        config.num_random_variables
+        ? config.num_random_variables : n_available_features);
+    vector<int> split_features_i;
+    if (n_split_features == n_available_features) {
+        split_features_i = np::range<int> (n_available_features);
+    }
+    else {
+        split_features_i = sampler.sample_range<int> (
+            n_split_features, 0, n_available_features);
+    }
+
+    // one interleaved g, h and count histogram per feature, filled in a
+    // single pass; the best cut maximizes
+    // G_L^2 / (H_L + l2) + G_R^2 / (H_R + l2)
+    double best_sep_gain (0);
+    int best_i_f (-1);
+    double best_cut_val (numeric_limits<double>::quiet_NaN ());
+    for (int i_i_f (0); i_i_f < n_split_features; ++i_i_f) {
+        const int i_f (split_features_i[i_i_f]);
+        ProfileScope histogram_scope (
+            profile, "histogram", n_sig + n_bg,
+            GradientHistogram::N_SUMS * (config.num_cuts + 1)
+            * sizeof (double));
+        boost::shared_ptr<GradientHistogram> hist;
+        if (config.linear_cuts) {
+            double min_val (numeric_limits<double>::max ());
+            double max_val (-numeric_limits<double>::max ());
+            for (int i (0); i < n_sig; ++i) {
+                min_val = min (min_val, sig_events[i].value (i_f));
+                max_val = max (max_val, sig_events[i].value (i_f));
+            }
+            for (int i (0); i < n_bg; ++i) {
+                min_val = min (min_val, bg_events[i].value (i_f));
+                max_val = max (max_val, bg_events[i].value (i_f));
+            }
+            hist = boost::make_shared<GradientHistogram> (
+                min_val, max_val, config.num_cuts + 1);
+        }
+        else {
+            hist = boost::make_shared<GradientHistogram> (bin_edges[i_f]);
+        }
+        hist->fill (sig_events, sig_g, sig_h, i_f);
+        hist->fill (bg_events, bg_g, bg_h, i_f);
+        histogram_scope.stop ();
+
+        ProfileScope scan_scope (profile, "split_scan");
+        double g_left (0), h_left (0), n_left (0);
+        const double* bin (hist->bins ());
+        const int n_bins (hist->n_bins ());
+        // cut is at right edge of bin -- don't bother checking last bin
+        for (int i_bin (0); i_bin < n_bins - 1;
+             ++i_bin, bin += GradientHistogram::N_SUMS) {
+            g_left += bin[GradientHistogram::G];
+            h_left += bin[GradientHistogram::H];
+            n_left += bin[GradientHistogram::N];
+            if (n_left < config.min_split) {
+                continue; // not enough to the left yet
+            }
+            if (n_sig + n_bg - n_left < config.min_split) {
+                break; // not enough remaining to the right anymore
+            }
+            const double g_right (g_here - g_left);
+            const double h_right (h_here - h_left);
+            const double sep_gain (g_left * g_left / (h_left + l2)
+                                   + g_right * g_right / (h_right + l2)
+                                   - score_here);
+            if (sep_gain > best_sep_gain) {
+                best_sep_gain = sep_gain;
+                best_i_f = i_f;
+                best_cut_val = hist->value_for_index (i_bin + 1);
+            }
+        }
+    }
+
+    if (best_i_f < 0) {
+        return leaf;
+    }
+
+    // use chosen split
+    ProfileScope partition_scope (
+        profile, "partition", n_sig + n_bg,
+        (n_sig + n_bg) * (sizeof (Event) + 3 * sizeof (double)));
+    vecev sig_left, sig_right, bg_left, bg_right;
+    vecd sig_weights_left, sig_weights_right;
+    vecd bg_weights_left, bg_weights_right;
+    vecd sig_g_left, sig_g_right, sig_h_left, sig_h_right;
+    vecd bg_g_left, bg_g_right, bg_h_left, bg_h_right;
+    for (int i (0); i < n_sig; ++i) {
+        if (sig_events[i].value (best_i_f) < best_cut_val) {
+            sig_left.push_back (sig_events[i]);
+            sig_weights_left.push_back (sig_weights[i]);
+            sig_g_left.push_back (sig_g[i]);
+            sig_h_left.push_back (sig_h[i]);
+        }
+        else {
+            sig_right.push_back (sig_events[i]);
+            sig_weights_right.push_back (sig_weights[i]);
+            sig_g_right.push_back (sig_g[i]);
+            sig_h_right.push_back (sig_h[i]);
+        }
+    }
+    for (int i (0); i < n_bg; ++i) {
+        if (bg_events[i].value (best_i_f) < best_cut_val) {
+            bg_left.push_back (bg_events[i]);
+            bg_weights_left.push_back (bg_weights[i]);
+            bg_g_left.push_back (bg_g[i]);
+            bg_h_left.push_back (bg_h[i]);
+        }
+        else {
+            bg_right.push_back (bg_events[i]);
+            bg_weights_right.push_back (bg_weights[i]);
+            bg_g_right.push_back (bg_g[i]);
+            bg_h_right.push_back (bg_h[i]);
+        }
+    }
+    partition_scope.stop ();
+    boost::shared_ptr<DTNode> left (build_newton_tree (
+            config, sampler, sig_left, bg_left,
+            sig_weights_left, bg_weights_left,
+            sig_g_left, sig_h_left, bg_g_left, bg_h_left,
+            learning_rate, l2, bin_edges, depth + 1));
+    boost::shared_ptr<DTNode> right (build_newton_tree (
+            config, sampler, sig_right, bg_right,
+            sig_weights_right, bg_weights_right,
+            sig_g_right, sig_h_right, bg_g_right, bg_h_right,
+            learning_rate, l2, bin_edges, depth + 1));
+    boost::shared_ptr<DTNode> node (new DTNode (
+            best_sep_gain, score_here, best_i_f, best_cut_val,
+            w_sig, w_bg, n_sig, n_bg, left, right));
+    // kept on inner nodes too, so that pruning to a node leaves the
+    // right response behind
+    node->response (leaf->response ());
+    return node;
+}
+
 boost::shared_ptr<Model>
-RegLearner::train_given_targets (const vector<Event>& sig,
+RegLearner::train_given_targets (const DTConfig& config,
+                                 RandomSampler& sampler,
+                                 const vector<Event>& sig,
                                    const vector<Event>& bg,
                                    const vector<double>& sig_weights,
                                    const vector<double>& bg_weights,
@@ -520,6 +780,7 @@ RegLearner::train_given_targets (const vector<Event>& sig,
     assert (sig.size () == sig_targets.size ());
     assert (bg.size () == bg_targets.size ());
     boost::shared_ptr<DTNode> root = build_reg_tree (
+        config, sampler,
         sig, bg, sig_weights, bg_weights, sig_targets,bg_targets);
     return boost::make_shared<DTModel> (m_feature_names, root);
 }
@@ -550,6 +811,7 @@ double RegLearner::NodeSumSquaredError(
 //Have separate method for regression trees. Possibly there is a way of integrating this all into one method that happily merges with the Learner paradigm, but since I had to make a separate train_given_targets, then I will also have a separate build_reg_tree
 boost::shared_ptr<DTNode>
 RegLearner::build_reg_tree (
+    const DTConfig& config, RandomSampler& sampler,
     const vector<Event>& sig_events,
     const vector<Event>& bg_events,
     const vector<double>& sig_weights, const vector<double>& bg_weights,
@@ -569,17 +831,18 @@ RegLearner::build_reg_tree (
     double w_bg (np::sum (bg_weights));
     const double w_here (w_sig + w_bg);
     const double sserror_here = RegLearner::NodeSumSquaredError(sig_targets,bg_targets);
-    const double sep_here ((*m_sep_func) (sserror_here));
+    const double sep_here ((*config.sep_func) (sserror_here));
 
     // if too few events, max depth, or all one type, then make leaf now
-    if ((n_sig + n_bg < m_min_split)
-        or depth == m_max_depth or n_sig == 0 or n_bg == 0) {
+    if ((n_sig + n_bg < config.min_split)
+        or depth == config.max_depth or n_sig == 0 or n_bg == 0) {
         return boost::make_shared<DTNode> (sep_here, w_sig, w_bg, n_sig, n_bg);
     }
 
     const int n_available_features (m_feature_names.size ());
     const int n_split_features (
-        m_num_random_variables ? m_num_random_variables : n_available_features);
+        config.num_random_variables
+        ? config.num_random_variables : n_available_features);
 
     // get indices of features in m_feature_names
     vector<int> split_features_i;
@@ -587,7 +850,7 @@ RegLearner::build_reg_tree (
         split_features_i = np::range<int> (n_available_features);
     }
     else {
-        split_features_i = m_random_sampler.sample_range<int> (
+        split_features_i = sampler.sample_range<int> (
             n_split_features, 0, n_available_features);
     }
 
@@ -665,21 +928,27 @@ RegLearner::build_reg_tree (
             bg_values.push_back (value);
         }
         boost::shared_ptr<NonlinearHistogram> h;
-        if (m_linear_cuts) {
+        if (config.linear_cuts) {
           h_bg_targets = bg_targets;
           h_sig_targets = sig_targets;
 	  w_sig_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
 	  w_bg_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
 	  t_sig_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
 	  t_bg_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
 	  n_sig_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
 	  n_bg_hists.push_back (boost::make_shared<LinearHistogram> (
-                    feature_mins[i_i_f], feature_maxs[i_i_f], m_num_cuts + 1));
+                    feature_mins[i_i_f], feature_maxs[i_i_f],
+                    config.num_cuts + 1));
             w_sig_hists[i_i_f]->fill (sig_values, sig_weights);
             t_sig_hists[i_i_f]->fill (sig_values, sig_targets);
             n_sig_hists[i_i_f]->fill (sig_values);
@@ -726,7 +995,7 @@ RegLearner::build_reg_tree (
                 bg_sorted_targets.begin (), bg_sorted_targets.end ());
              
             vecd bin_edges (NonlinearHistogram::get_ntile_boundaries (
-                    m_num_cuts, all_values, all_sorted_weights));
+                    config.num_cuts, all_values, all_sorted_weights));
 
             h = boost::make_shared<NonlinearHistogram> (bin_edges);
             h->fill_presorted (sig_sorted_values, sig_sorted_weights);
@@ -804,10 +1073,10 @@ RegLearner::build_reg_tree (
              n_bg_right -= *i_n_h_bg;
             const double n_left = n_sig_left + n_bg_left;
             const double n_right = n_sig_right + n_bg_right;
-            if (n_left < m_min_split) {
+            if (n_left < config.min_split) {
                 continue; // not enough to the left yet
             }
-            if (n_right < m_min_split) {
+            if (n_right < config.min_split) {
                 break; // not enough remaining to the right anymore
             }
             const double w_left = w_sig_left + w_bg_left;
@@ -830,8 +1099,8 @@ RegLearner::build_reg_tree (
             }
             const double sserror_left = RegLearner::NodeSumSquaredError(t_sig_left,t_bg_left);
             const double sserror_right = RegLearner::NodeSumSquaredError(t_sig_right,t_bg_right);
-            const double sep_left = (*m_sep_func) (sserror_left);
-            const double sep_right = (*m_sep_func) (sserror_right);
+            const double sep_left = (*config.sep_func) (sserror_left);
+            const double sep_right = (*config.sep_func) (sserror_right);
             const double sep_gain = w_here * sep_here
                 - (w_left * sep_left) - (w_right * sep_right);
             if (sep_gain > best_sep_gain) {
@@ -911,11 +1180,13 @@ RegLearner::build_reg_tree (
         }
 
         boost::shared_ptr<DTNode> left (build_reg_tree (
+                config, sampler,
                 sig_left, bg_left,
                 sig_weights_left, bg_weights_left,
                 sig_targets_left, bg_targets_left,
                 depth + 1));
         boost::shared_ptr<DTNode> right (build_reg_tree (
+                config, sampler,
                 sig_right, bg_right,
                 sig_weights_right, bg_weights_right,
                 sig_targets_right, bg_targets_right,
@@ -928,52 +1199,3 @@ RegLearner::build_reg_tree (
     }
     return boost::make_shared<DTNode> (sep_here, w_sig, w_bg, n_sig, n_bg);
 }
-
-
-void
-export_dtlearner ()
-{
-    using namespace boost::python;
-   
-    class_<DTLearner, bases<Learner> > (
-        "DTLearner",
-        "Train a single decision tree."
-        ,init<py::list>())
-        .def (init<py::list,string> ())
-        .def (init<py::list,string,string> ())
-        .def ("set_defaults", &DTLearner::set_defaults)
-        .add_property (
-            "linear_cuts", 
-            (bool (DTLearner::*)()const) &DTLearner::linear_cuts,
-            (void (DTLearner::*)(bool)) &DTLearner::linear_cuts)
-        .add_property (
-            "max_depth", 
-            (int (DTLearner::*)()const) &DTLearner::max_depth,
-            (void (DTLearner::*)(int)) &DTLearner::max_depth)
-        .add_property (
-            "min_split", 
-            (int (DTLearner::*)()const) &DTLearner::min_split,
-            (void (DTLearner::*)(int)) &DTLearner::min_split)
-        .add_property (
-            "num_cuts", 
-            (int (DTLearner::*)()const) &DTLearner::num_cuts,
-            (void (DTLearner::*)(int)) &DTLearner::num_cuts)
-        .add_property (
-            "num_random_variables",
-            (int (DTLearner::*)()const) &DTLearner::num_random_variables,
-            (void (DTLearner::*)(int)) &DTLearner::num_random_variables)
-        .add_property (
-            "separation_type",
-            (std::string (DTLearner::*)()const)&DTLearner::separation_type,
-            (void (DTLearner::*)(std::string)) &DTLearner::separation_type)
-        ;
-        class_<RegLearner,bases<DTLearner> >(
-        "RegLearner",
-        "Train a single regression tree."
-        ,init<py::list,string,string>())
-        //.def (init<py::list,string> ())
-        .def (init<py::list,string,string> ())
-        ;
-    register_ptr_to_python <boost::shared_ptr<DTLearner> > ();
-    register_ptr_to_python <boost::shared_ptr<RegLearner> > ();
-}
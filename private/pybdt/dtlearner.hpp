@@ -11,78 +11,32 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
 
-#include "boost_python.hpp"
-
 #include "dataset.hpp"
 #include "dtmodel.hpp"
 #include "learner.hpp"
 #include "random_sampler.hpp"
-
-
-struct SepFunc {
-    virtual double operator() (double p) const = 0;
-    virtual std::string separation_type () const = 0;
-};
-struct SepGini : public SepFunc {
-    virtual double operator() (double p) const;
-    virtual std::string separation_type () const;
-};
-struct SepCrossEntropy : public SepFunc {
-    virtual double operator() (double p) const;
-    virtual std::string separation_type () const;
-};
-struct SepMisclassError : public SepFunc {
-    virtual double operator() (double p) const;
-    virtual std::string separation_type () const;
-};
-
-struct SumSquaredError : public SepFunc {
-    virtual double operator() (double p) const;
-    virtual std::string separation_type () const;
+#include "separation.hpp"
+#include "training_profile.hpp"
+
+
+// Snapshot of the DTLearner options used for one training.  Training only
+// ever reads a DTConfig, so the learner's own options may be changed, or
+// several trainings run concurrently, without affecting each other.
+struct DTConfig {
+    boost::shared_ptr<const SepFunc> sep_func;
+    int min_split;
+    int max_depth;
+    int num_cuts;
+    bool linear_cuts;
+    int num_random_variables;
+    // null unless profiling
+    boost::shared_ptr<TrainingProfile> profile;
 };
 
-inline double SepGini::operator() (double p) const
-{
-    return p * (1 - p);
-}
-inline std::string SepGini::separation_type () const
-{
-    return "gini";
-}
-
-inline double SepCrossEntropy::operator() (double p) const
-{
-    using std::log;
-    return -p * log (p) - (1-p) * log (1 - p);
-}
-inline std::string SepCrossEntropy::separation_type () const
-{
-    return "cross_entropy";
-}
-
-inline double SepMisclassError::operator() (double p) const
-{
-    return 1 - std::max (p, 1-p);
-}
-inline std::string SepMisclassError::separation_type () const
-{
-    return "misclass_error";
-}
-//Pretty dumb to just return the input value, but it works for now
-inline double SumSquaredError::operator() (double p) const
-{
-    return p;
-}
-inline std::string SumSquaredError::separation_type () const
-{
-    return "sumsquared_error";
-}
-
 
 class DTLearner : public Learner {
 public:
     friend class BDTLearner;
-    friend class BDTLearner_pickle_suite;
 
 
     // structors
@@ -96,15 +50,6 @@ public:
 
     virtual ~DTLearner ();
 
-    // structors for Python
-
-    explicit DTLearner (const boost::python::list& feature_names,
-                        const std::string& weight_name="");
-
-    DTLearner (const boost::python::list& feature_names,
-               const std::string& sig_weight_name,
-               const std::string& bg_weight_name);
-
 
     // inspectors
 
@@ -113,8 +58,15 @@ public:
     int min_split () const;
     int num_cuts () const;
     int num_random_variables () const;
+    boost::shared_ptr<TrainingProfile> profile () const;
+    bool profiling () const;
+    int seed () const;
     std::string separation_type () const;
 
+    DTConfig config () const;
+
+    static boost::shared_ptr<SepFunc> make_sep_func (const std::string& st);
+
     // mutators
 
     void max_depth (int n);
@@ -122,24 +74,66 @@ public:
     void num_cuts (int n);
     void linear_cuts (bool value);
     void num_random_variables (int n);
+    void profiling (bool value);
+    void seed (int n);
     void separation_type (std::string st);
     void set_defaults ();
     virtual boost::shared_ptr<Model> train_given_everything (
+        const std::vector<Event>& sig,
+        const std::vector<Event>& bg,
+        const std::vector<double>& sig_weights,
+        const std::vector<double>& bg_weights,
+        TrainingStatus* status=0) const;
+
+    // train one tree with the given options, drawing random numbers from
+    // sampler; re-entrant as long as each caller owns its sampler
+    boost::shared_ptr<DTModel> train_given_config (
+        const DTConfig& config, RandomSampler& sampler,
         const std::vector<Event>& sig,
         const std::vector<Event>& bg,
         const std::vector<double>& sig_weights,
         const std::vector<double>& bg_weights) const;
 
+    // train one tree for second order gradient boosting: splits maximize
+    // the gain in sum (g)^2 / (sum (h) + l2), and each leaf's response is
+    // the Newton step -learning_rate * sum (g) / (sum (h) + l2); the
+    // weights only fill in the node statistics
+    boost::shared_ptr<DTModel> train_given_gradients (
+        const DTConfig& config, RandomSampler& sampler,
+        const std::vector<Event>& sig,
+        const std::vector<Event>& bg,
+        const std::vector<double>& sig_weights,
+        const std::vector<double>& bg_weights,
+        const std::vector<double>& sig_g, const std::vector<double>& sig_h,
+        const std::vector<double>& bg_g, const std::vector<double>& bg_h,
+        double learning_rate, double l2) const;
+
 
 protected:
 
+    // scan is config.sep_func->split_scan (), looked up once per tree
     boost::shared_ptr<DTNode> build_tree (
+        const DTConfig& config, SplitScanFunc scan, RandomSampler& sampler,
         const std::vector<Event>& sig,
         const std::vector<Event>& bg,
         const std::vector<double>& sig_weights,
         const std::vector<double>& bg_weights,
         const int depth=0) const;
 
+    // with nonlinear cuts, bin_edges holds each feature's bins of equal
+    // hessian over the whole tree; otherwise it is empty
+    boost::shared_ptr<DTNode> build_newton_tree (
+        const DTConfig& config, RandomSampler& sampler,
+        const std::vector<Event>& sig,
+        const std::vector<Event>& bg,
+        const std::vector<double>& sig_weights,
+        const std::vector<double>& bg_weights,
+        const std::vector<double>& sig_g, const std::vector<double>& sig_h,
+        const std::vector<double>& bg_g, const std::vector<double>& bg_h,
+        double learning_rate, double l2,
+        const std::vector<std::vector<double> >& bin_edges,
+        const int depth=0) const;
+
     static
     boost::tuple<double, double> m_sum_passing_weight (
         const double cut_val, const std::vector<double>& feature_col,
@@ -153,7 +147,8 @@ protected:
     bool m_linear_cuts;
 
     int m_num_random_variables;
-    mutable RandomSampler m_random_sampler;
+    int m_seed;
+    boost::shared_ptr<TrainingProfile> m_profile;
 };
 
 class RegLearner : public DTLearner{
@@ -162,10 +157,6 @@ public:
                const std::string& sig_weight_name,
                const std::string& bg_weight_name);
 
-    RegLearner (const boost::python::list& feature_names,
-               const std::string& sig_weight_name,
-               const std::string& bg_weight_name);
-
     virtual ~RegLearner ();
 protected:
     double NodeTargetAverage(const std::vector<double>& sig_targets,
@@ -175,6 +166,7 @@ protected:
                                const std::vector<double>& bg_targets) const;
 
     boost::shared_ptr<Model> train_given_targets (
+        const DTConfig& config, RandomSampler& sampler,
         const std::vector<Event>& sig,
         const std::vector<Event>& bg,
         const std::vector<double>& sig_weights,
@@ -183,6 +175,7 @@ protected:
         const std::vector<double>& bg_targets) const;
 
     boost::shared_ptr<DTNode> build_reg_tree (
+        const DTConfig& config, RandomSampler& sampler,
         const std::vector<Event>& sig,
         const std::vector<Event>& bg,
         const std::vector<double>& sig_weights,
@@ -194,8 +187,5 @@ protected:
 };
 
 
-void export_dtlearner ();
-
-
 
 #endif  /* PYBDT_DTLEARNER_HPP */
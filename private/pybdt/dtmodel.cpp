@@ -1,9 +1,6 @@
 // dtmodel.cpp
 
-#include <Python.h>
-
 #include "dtmodel.hpp"
-#include "np.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -16,8 +13,6 @@
 
 using namespace std;
 using namespace boost;
-using namespace boost::python;
-namespace py = boost::python;
 
 
 // DTNode -----------------------------------------------------------
@@ -29,9 +24,11 @@ DTNode::DTNode (double sep_index,
     m_feature_val (numeric_limits<double>::quiet_NaN ()),
     m_w_sig (w_sig), m_w_bg (w_bg),
     m_n_sig (n_sig), m_n_bg (n_bg),
-    m_left (), m_right ()
+    m_response (0),
+    m_left (), m_right (), m_parent (0)
 {
     calc_aux ();
+    calc_subtree ();
 }
 
 DTNode::DTNode (double sep_gain, double sep_index,
@@ -43,13 +40,32 @@ DTNode::DTNode (double sep_gain, double sep_index,
     m_feature_id (feature_id), m_feature_val (feature_val),
     m_w_sig (w_sig), m_w_bg (w_bg),
     m_n_sig (n_sig), m_n_bg (n_bg),
-    m_left (left), m_right (right)
+    m_response (0),
+    m_left (left), m_right (right), m_parent (0)
 {
+    if (m_left) {
+        if (m_left->m_parent) {
+            m_left = m_left->get_copy ();
+        }
+        m_left->m_parent = this;
+        if (m_right->m_parent) {
+            m_right = m_right->get_copy ();  // also if right == left
+        }
+        m_right->m_parent = this;
+    }
     calc_aux ();
+    calc_subtree ();
 }
 
 DTNode::~DTNode ()
 {
+    // the children may outlive this node, e.g. if held from Python
+    if (m_left and m_left->m_parent == this) {
+        m_left->m_parent = 0;
+    }
+    if (m_right and m_right->m_parent == this) {
+        m_right->m_parent = 0;
+    }
 }
 
 void
@@ -74,39 +90,6 @@ DTNode::feature_name () const
     }
 }
 
-int
-DTNode::tree_size () const
-{
-    if (is_leaf ()) {
-        return 1;
-    }
-    else {
-        return 1 + m_left->tree_size () + m_right->tree_size ();
-    }
-}
-
-int
-DTNode::max_depth () const
-{
-    if (is_leaf ()) {
-        return 0;
-    }
-    else {
-        return 1 + max (m_left->max_depth (), m_right->max_depth ());
-    }
-}
-
-int
-DTNode::n_leaves () const
-{
-    if (is_leaf ()) {
-        return 1;
-    }
-    else {
-        return m_left->n_leaves () + m_right->n_leaves ();
-    }
-}
-
 int
 DTNode::n_total () const
 {
@@ -123,8 +106,15 @@ void
 DTNode::prune ()
 {
     m_feature_id = m_w_sig > m_w_bg ? 1 : -1;
+    if (m_left) {
+        m_left->m_parent = 0;
+        m_right->m_parent = 0;
+    }
     m_left = boost::shared_ptr<DTNode> ();
     m_right = boost::shared_ptr<DTNode> ();
+    for (DTNode* node (this); node; node = node->m_parent) {
+        node->calc_subtree ();
+    }
 }
 
 const DTNode&
@@ -172,9 +162,17 @@ DTNode::get_copy () const
         left = m_left->get_copy ();
         right = m_right->get_copy ();
     }
-    return boost::shared_ptr<DTNode> (
+    boost::shared_ptr<DTNode> out (
         new DTNode (m_sep_gain, m_sep_index, m_feature_id, m_feature_val,
                     m_w_sig, m_w_bg, m_n_sig, m_n_bg, left, right));
+    out->m_response = m_response;
+    return out;
+}
+
+void
+DTNode::response (double response)
+{
+    m_response = response;
 }
 
 void
@@ -183,15 +181,19 @@ DTNode::calc_aux ()
     m_purity = m_w_sig / w_total ();
 }
 
-
-py::tuple
-DTNode_pickle_suite::getinitargs (const DTNode& n)
+void
+DTNode::calc_subtree ()
 {
-    return py::make_tuple (
-        n.m_sep_gain, n.m_sep_index, n.m_feature_id, n.m_feature_val,
-        n.m_w_sig, n.m_w_bg,
-        n.m_n_sig, n.m_n_bg,
-        n.m_left, n.m_right);
+    if (is_leaf ()) {
+        m_tree_size = 1;
+        m_n_leaves = 1;
+        m_max_depth = 0;
+    }
+    else {
+        m_tree_size = 1 + m_left->m_tree_size + m_right->m_tree_size;
+        m_n_leaves = m_left->m_n_leaves + m_right->m_n_leaves;
+        m_max_depth = 1 + max (m_left->m_max_depth, m_right->m_max_depth);
+    }
 }
 
 
@@ -208,12 +210,6 @@ DTModel::DTModel (const vector<string>& feature_names,
 DTModel::~DTModel ()
 { }
 
-DTModel::DTModel (const py::list& feature_names, boost::shared_ptr<DTNode> root)
-    : Model (feature_names), m_root (root)
-{
-    root->set_dtmodel (this);
-}
-
 
 vector<double>
 DTModel::event_variable_importance (
@@ -247,20 +243,6 @@ DTModel::event_variable_importance (
     return rel_var_imp;
 }
 
-dict
-DTModel::event_variable_importance_py (
-    const py::list& vals, bool sep_weighted) const
-{
-    vector<double> var_imp (event_variable_importance (
-            make_scoreable (np::list_to_vector<double> (vals)),
-            sep_weighted));
-    dict out;
-    for (int i_f (0); i_f < m_n_features; ++i_f) {
-        out[m_feature_names[i_f]] = var_imp[i_f];
-    }
-    return out;
-}
-
 vector<double>
 DTModel::variable_importance (bool sep_weighted) const
 {
@@ -295,17 +277,6 @@ DTModel::variable_importance (bool sep_weighted) const
     return rel_var_imp;
 }
 
-dict
-DTModel::variable_importance_py (bool sep_weighted) const
-{
-    vector<double> var_imp = variable_importance (sep_weighted);
-    dict out;
-    for (int i_f (0); i_f < m_n_features; ++i_f) {
-        out[m_feature_names[i_f]] = var_imp[i_f];
-    }
-    return out;
-}
-
 double
 DTModel::base_score (const Scoreable& e, bool use_purity) const
 {
@@ -317,58 +288,3 @@ DTModel::base_score (const Scoreable& e, bool use_purity) const
         return leaf.purity () > 0.5 ? +1 : -1;
     }
 }
-
-py::tuple
-DTModel_pickle_suite::getinitargs (const DTModel& m)
-{
-    list py_feature_names;
-    for (unsigned i = 0; i < m.m_feature_names.size (); ++i) {
-        py_feature_names.append (m.m_feature_names[i]);
-    }
-    return py::make_tuple (
-        py_feature_names, m.m_root);
-}
-
-void
-export_dtmodel ()
-{
-    class_<DTNode> (
-        "DTNode",
-        init<double,double,int,double,double,double,int,int,
-        boost::shared_ptr<DTNode>,boost::shared_ptr<DTNode> >())
-        .add_property ("feature_id", &DTNode::feature_id)
-        .add_property ("feature_name", &DTNode::feature_name)
-        .add_property ("feature_val", &DTNode::feature_val)
-        .add_property ("is_leaf", &DTNode::is_leaf)
-        .add_property ("left", &DTNode::left)
-        .add_property ("max_depth", &DTNode::max_depth)
-        .add_property ("n_bg", &DTNode::n_bg)
-        .add_property ("n_leaves", &DTNode::n_leaves)
-        .add_property ("n_sig", &DTNode::n_sig)
-        .add_property ("n_total", &DTNode::n_total)
-        .add_property ("purity", &DTNode::purity)
-        .add_property ("right", &DTNode::right)
-        .add_property ("sep_gain", &DTNode::sep_gain)
-        .add_property ("sep_index", &DTNode::sep_gain)
-        .add_property ("tree_size", &DTNode::tree_size)
-        .add_property ("w_bg", &DTNode::w_bg)
-        .add_property ("w_sig", &DTNode::w_sig)
-        .add_property ("w_total", &DTNode::w_total)
-        .def ("prune", &DTNode::prune)
-        .def_pickle (DTNode_pickle_suite ())
-        ;
-
-
-    class_<DTModel, bases<Model> > (
-        "DTModel", init<const py::list&,boost::shared_ptr<DTNode> > ())
-        .def ("event_variable_importance",
-              &DTModel::event_variable_importance_py)
-        .def ("variable_importance",
-              &DTModel::variable_importance_py)
-        .add_property ("root", &DTModel::root)
-        .def_pickle (DTModel_pickle_suite ())
-        ;
-
-    register_ptr_to_python <boost::shared_ptr<DTNode> > ();
-    register_ptr_to_python <boost::shared_ptr<DTModel> > ();
-}
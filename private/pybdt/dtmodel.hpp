@@ -7,7 +7,6 @@
 #include <string>
 #include <vector>
 
-#include "boost_python.hpp"
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -16,10 +15,13 @@
 class DTModel;
 
 class DTNode : public boost::enable_shared_from_this<DTNode> {
-    friend class DTNode_pickle_suite;
     // policy:
     // if left == right = null, it's a leaf.
     // for leaves, feature_id is +1 for signal, -1 for background
+    // a node belongs to one tree: its children point back at it, so that
+    // the subtree sizes and depths cached on each node can be kept up to
+    // date along the path to the root when a node is pruned.  Nodes may
+    // not be shared between parents
 public:
 
     // structors
@@ -27,7 +29,7 @@ public:
     // for leaf
     DTNode (double sep_index, double w_sig, double w_bg, int n_sig, int n_bg);
 
-    // for node
+    // for node; a child that already has a parent is deep copied
     DTNode (double sep_gain, double sep_index,
             int feature_id, double feature_val,
             double w_sig, double w_bg,
@@ -53,6 +55,7 @@ public:
     int n_total () const;
     double n_sig () const;
     double purity () const;
+    double response () const;
     double sep_index () const;
     double sep_gain () const;
     int tree_size () const;
@@ -68,6 +71,9 @@ public:
 
     void prune ();
 
+    // leaf value fit by gradient boosting (0 unless set)
+    void response (double response);
+
     // helpers
 
     const DTNode& trace (const Scoreable& e);
@@ -80,6 +86,8 @@ public:
 protected:
 
     void calc_aux ();
+    // subtree statistics from those of the children
+    void calc_subtree ();
 
     double m_sep_gain;
     double m_sep_index;
@@ -92,22 +100,21 @@ protected:
     int m_n_sig;
     int m_n_bg;
     double m_purity;
+    double m_response;
 
     boost::shared_ptr<DTNode> m_left;
     boost::shared_ptr<DTNode> m_right;
+    DTNode* m_parent;
 
-    DTModel* m_dtmodel;
+    int m_tree_size;
+    int m_n_leaves;
+    int m_max_depth;
 
-};
+    DTModel* m_dtmodel;
 
-struct DTNode_pickle_suite : boost::python::pickle_suite {
-    static
-    boost::python::tuple getinitargs (const DTNode& n);
 };
 
 class DTModel : public Model {
-    friend class DTModel_pickle_suite;
-
 public:
 
     // structors
@@ -118,21 +125,13 @@ public:
 
     virtual ~DTModel ();
 
-    // structors for Python
-
-    DTModel (const boost::python::list& feature_names,
-             boost::shared_ptr<DTNode> root);
-
     // inspectors
 
     std::vector<double> event_variable_importance (
         const Scoreable& s, bool sep_weighted) const;
-    boost::python::dict event_variable_importance_py (
-        const boost::python::list& vals, bool sep_weighted) const;
     std::vector<double> variable_importance (bool sep_weighted) const;
-    boost::python::dict variable_importance_py (bool sep_weighted) const;
 
-    boost::shared_ptr<DTNode> root ();
+    boost::shared_ptr<DTNode> root () const;
 
 protected:
 
@@ -141,14 +140,6 @@ protected:
     boost::shared_ptr<DTNode>  m_root;
 };
 
-struct DTModel_pickle_suite : boost::python::pickle_suite {
-    static
-    boost::python::tuple getinitargs (const DTModel& m);
-};
-
-
-void export_dtmodel ();
-
 
 
 inline int
@@ -169,12 +160,24 @@ DTNode::is_leaf () const
     return ! bool (m_left);
 }
 
+inline int
+DTNode::max_depth () const
+{
+    return m_max_depth;
+}
+
 inline double
 DTNode::n_bg () const
 {
     return m_n_bg;
 }
 
+inline int
+DTNode::n_leaves () const
+{
+    return m_n_leaves;
+}
+
 inline double
 DTNode::n_sig () const
 {
@@ -187,6 +190,12 @@ DTNode::purity () const
     return m_purity;
 }
 
+inline double
+DTNode::response () const
+{
+    return m_response;
+}
+
 inline double
 DTNode::sep_index () const
 {
@@ -199,6 +208,12 @@ DTNode::sep_gain () const
     return m_sep_gain;
 }
 
+inline int
+DTNode::tree_size () const
+{
+    return m_tree_size;
+}
+
 inline double
 DTNode::w_bg () const
 {
@@ -224,7 +239,7 @@ DTNode::right () const
 }
 
 inline boost::shared_ptr<DTNode>
-DTModel::root ()
+DTModel::root () const
 {
     return m_root;
 }
@@ -0,0 +1,57 @@
+// gbmodel.cpp
+
+#include "gbmodel.hpp"
+
+#include <cmath>
+
+using namespace std;
+using namespace boost;
+
+
+GBModel::GBModel (const vector<string>& feature_names,
+                  const vector<boost::shared_ptr<DTModel> >& dtmodels,
+                  double f0)
+: Model (feature_names), m_dtmodels (dtmodels), m_f0 (f0)
+{
+}
+
+GBModel::~GBModel ()
+{
+}
+
+double
+GBModel::f0 () const
+{
+    return m_f0;
+}
+
+boost::shared_ptr<DTModel>
+GBModel::get_dtmodel (int n) const
+{
+    return m_dtmodels.at (n);
+}
+
+int
+GBModel::n_dtmodels () const
+{
+    return m_dtmodels.size ();
+}
+
+double
+GBModel::raw_score (const Scoreable& e) const
+{
+    double F (m_f0);
+    typedef vector<boost::shared_ptr<DTModel> >::const_iterator citer;
+    for (citer i_dtmodel = m_dtmodels.begin ();
+         i_dtmodel != m_dtmodels.end (); ++i_dtmodel) {
+        F += (*i_dtmodel)->root ()->trace (e).response ();
+    }
+    return F;
+}
+
+double
+GBModel::base_score (const Scoreable& e, bool /* use_purity */) const
+{
+    // use_purity does not apply: the leaves carry fitted responses
+    return tanh (raw_score (e) / 2);
+}
@@ -0,0 +1,50 @@
+// gbmodel.hpp
+
+
+#ifndef PYBDT_GBMODEL_HPP
+#define PYBDT_GBMODEL_HPP
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "dtmodel.hpp"
+#include "model.hpp"
+
+
+// Gradient boosted trees with a logistic loss.  The raw score F is f0
+// plus the sum of the responses of the leaves each event falls into, and
+// the score is tanh (F / 2) = 2 P(signal) - 1.
+class GBModel : public Model {
+public:
+
+    // structors
+
+    GBModel (const std::vector<std::string>& feature_names,
+             const std::vector<boost::shared_ptr<DTModel> >& dtmodels,
+             double f0);
+
+    virtual ~GBModel ();
+
+
+    // inspectors
+
+    double f0 () const;
+    boost::shared_ptr<DTModel> get_dtmodel (int n) const;
+    int n_dtmodels () const;
+
+    double raw_score (const Scoreable& e) const;
+
+
+protected:
+
+    virtual double base_score (const Scoreable& e, bool use_purity) const;
+
+
+private:
+    std::vector<boost::shared_ptr<DTModel> > m_dtmodels;
+    double m_f0;
+};
+
+#endif  /* PYBDT_GBMODEL_HPP */
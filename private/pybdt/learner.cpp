@@ -1,17 +1,18 @@
 // learner.cpp
 
-#include <Python.h>
-
 #include "learner.hpp"
 
 #include "np.hpp"
+#include "parallel.hpp"
 
 #include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 
 
 using namespace std;
 using namespace boost;
-namespace py = boost::python;
 
 
 // structors
@@ -37,27 +38,6 @@ Learner::~Learner ()
 {
 }
 
-// structors for Python
-
-Learner::Learner (const py::list& feature_names,
-                  const string& weight_name)
-:   m_feature_names (np::list_to_vector<string> (feature_names)),
-    m_sig_weight_name (weight_name),
-    m_bg_weight_name (weight_name)
-{
-    init ();
-}
-
-Learner::Learner (const py::list& feature_names,
-                  const std::string& sig_weight_name,
-                  const std::string& bg_weight_name)
-:   m_feature_names (np::list_to_vector<string> (feature_names)),
-    m_sig_weight_name (sig_weight_name),
-    m_bg_weight_name (bg_weight_name)
-{
-    init ();
-}
-
 
 // structor helper
 void
@@ -87,71 +67,220 @@ Learner::bg_weight_name () const
 }
 
 
+void
+Learner::start_training () const
+{
+}
+
+
 // factory methods
 
 boost::shared_ptr<Model>
-Learner::train (const DataSet& sig, const DataSet& bg) const
+Learner::train (const DataSet& sig, const DataSet& bg,
+                TrainingStatus* status) const
 {
-    vector<double> sig_weights = m_sig_weight_name.size ()
-        ? sig.get_column (m_sig_weight_name)
-        : np::ones<double> (sig.n_events ());
-    vector<double> bg_weights = m_bg_weight_name.size ()
-        ? bg.get_column (m_bg_weight_name)
-        : np::ones<double> (bg.n_events ());
-
-    sig_weights = np::div (sig_weights, np::sum (sig_weights));
-    bg_weights = np::div (bg_weights, np::sum (bg_weights));
-
-    return train_given_weights (sig, bg, sig_weights, bg_weights);
+    return train_given_weights (
+        sig, bg,
+        initial_weights (sig, m_sig_weight_name),
+        initial_weights (bg, m_bg_weight_name),
+        status);
 }
 
 boost::shared_ptr<Model>
 Learner::train_given_weights (const DataSet& sig, const DataSet& bg,
                               const vector<double>& sig_weights,
-                              const vector<double>& bg_weights) const
+                              const vector<double>& bg_weights,
+                              TrainingStatus* status) const
+{
+    start_training ();
+    const TrainingSample sample (
+        sig, bg, m_feature_names, sig_weights, bg_weights);
+    return train_given_everything (
+        sample.sig_events (), sample.bg_events (),
+        sample.sig_weights (), sample.bg_weights (), status);
+}
+
+boost::shared_ptr<Model>
+Learner::train_quietly (const vector<Event>& sig, const vector<Event>& bg,
+                        const vector<double>& init_sig_weights,
+                        const vector<double>& init_bg_weights,
+                        const string& /* run */,
+                        TrainingStatus* status) const
+{
+    return train_given_everything (
+        sig, bg, init_sig_weights, init_bg_weights, status);
+}
+
+namespace {
+
+// trains and scores fold f for parallel::parallel_for
+struct FoldTrainer {
+    FoldTrainer (const Learner& learner, const TrainingSample& sample,
+                 int k, CrossValidation& cv)
+        : learner (learner), sample (sample), k (k), cv (cv)
+    { }
+
+    // split the kept events into the training set and the held out fold
+    static void split (
+        const vector<Event>& events, const vector<double>& weights,
+        const vector<int>& keep, int k, int f,
+        vector<Event>& train_events, vector<double>& train_weights,
+        vector<Event>& test_events, vector<int>& test_indices)
+    {
+        const int n (events.size ());
+        for (int i (0); i < n; ++i) {
+            if (keep[i] % k == f) {
+                test_events.push_back (events[i]);
+                test_indices.push_back (keep[i]);
+            }
+            else {
+                train_events.push_back (events[i]);
+                train_weights.push_back (weights[i]);
+            }
+        }
+        train_weights = np::div (train_weights, np::sum (train_weights));
+    }
+
+    static void assign (vector<double>& scores, const vector<int>& indices,
+                        const vector<double>& values)
+    {
+        for (size_t i (0); i < indices.size (); ++i) {
+            scores[indices[i]] = values[i];
+        }
+    }
+
+    void operator() (int f)
+    {
+        vector<Event> train_sig, train_bg, test_sig, test_bg;
+        vector<double> train_sig_weights, train_bg_weights;
+        vector<int> test_sig_indices, test_bg_indices;
+        split (sample.sig_events (), sample.sig_weights (),
+               sample.sig_keep (), k, f,
+               train_sig, train_sig_weights, test_sig, test_sig_indices);
+        split (sample.bg_events (), sample.bg_weights (),
+               sample.bg_keep (), k, f,
+               train_bg, train_bg_weights, test_bg, test_bg_indices);
+        ostringstream run;
+        run << "fold " << f;
+        boost::shared_ptr<Model> model (learner.train_quietly (
+                train_sig, train_bg, train_sig_weights, train_bg_weights,
+                run.str ()));
+        // each fold writes a disjoint set of entries
+        assign (cv.sig_scores, test_sig_indices,
+                model->score (test_sig, false, true));
+        assign (cv.bg_scores, test_bg_indices,
+                model->score (test_bg, false, true));
+        cv.models[f] = model;
+    }
+
+    const Learner& learner;
+    const TrainingSample& sample;
+    const int k;
+    CrossValidation& cv;
+};
+
+}
+
+CrossValidation
+Learner::cross_validate (const DataSet& sig, const DataSet& bg,
+                         int k, int num_threads) const
+{
+    if (k < 2) {
+        throw runtime_error ("cross_validate needs at least 2 folds");
+    }
+    start_training ();
+    const TrainingSample sample (
+        sig, bg, m_feature_names,
+        initial_weights (sig, m_sig_weight_name),
+        initial_weights (bg, m_bg_weight_name));
+    const double nan (numeric_limits<double>::quiet_NaN ());
+    CrossValidation cv;
+    cv.models.resize (k);
+    cv.sig_scores.assign (sig.n_events (), nan);
+    cv.bg_scores.assign (bg.n_events (), nan);
+    FoldTrainer trainer (*this, sample, k, cv);
+    parallel::parallel_for (k, num_threads, trainer);
+    return cv;
+}
+
+
+// helpers
+
+vector<double>
+Learner::initial_weights (const DataSet& ds, const string& weight_name) const
+{
+    vector<double> weights = weight_name.size ()
+        ? ds.get_column (weight_name)
+        : np::ones<double> (ds.n_events ());
+    return np::div (weights, np::sum (weights));
+}
+
+
+// TrainingSample ---------------------------------------------------
+
+TrainingSample::TrainingSample (const DataSet& sig, const DataSet& bg,
+                                const vector<string>& feature_names,
+                                const vector<double>& sig_weights,
+                                const vector<double>& bg_weights)
+:   m_sig (sig, feature_names), m_bg (bg, feature_names)
 {
-    // get only columns that this learner uses
-    const DataSet& train_sig (DataSet (sig, m_feature_names));
-    const DataSet& train_bg (DataSet (bg, m_feature_names));
     // eliminate events with NaN's
-    vector<int> sig_keep;
-    vector<int> bg_keep;
-    const vector<Event>& sig_events (train_sig.events ());
-    const vector<Event>& bg_events (train_bg.events ());
-    sig_keep.reserve (train_sig.n_events ());
-    bg_keep.reserve (train_bg.n_events ());
+    const vector<Event>& sig_events (m_sig.events ());
+    const vector<Event>& bg_events (m_bg.events ());
+    m_sig_keep.reserve (m_sig.n_events ());
+    m_bg_keep.reserve (m_bg.n_events ());
     typedef vector<Event>::const_iterator citer;
     citer i_ev (sig_events.begin ());
     int i (0);
     for (; i_ev != sig_events.end (); ++i_ev, ++i) {
         if (i_ev->all_finite ()) {
-            sig_keep.push_back (i);
+            m_sig_keep.push_back (i);
         }
     }
     for (i = 0, i_ev = bg_events.begin ();
          i_ev != bg_events.end (); ++i_ev, ++i) {
         if (i_ev->all_finite ()) {
-            bg_keep.push_back (i);
+            m_bg_keep.push_back (i);
         }
     }
-    return train_given_everything (
-        np::subscript (sig_events, sig_keep),
-        np::subscript (bg_events, bg_keep),
-        np::subscript (sig_weights, sig_keep),
-        np::subscript (bg_weights, bg_keep));
+    m_sig_events = np::subscript (sig_events, m_sig_keep);
+    m_bg_events = np::subscript (bg_events, m_bg_keep);
+    m_sig_weights = np::subscript (sig_weights, m_sig_keep);
+    m_bg_weights = np::subscript (bg_weights, m_bg_keep);
 }
 
-void
-export_learner ()
+const vector<Event>&
+TrainingSample::sig_events () const
+{
+    return m_sig_events;
+}
+
+const vector<Event>&
+TrainingSample::bg_events () const
+{
+    return m_bg_events;
+}
+
+const vector<double>&
+TrainingSample::sig_weights () const
+{
+    return m_sig_weights;
+}
+
+const vector<double>&
+TrainingSample::bg_weights () const
 {
-    using namespace boost::python;
+    return m_bg_weights;
+}
 
-    class_<Learner, boost::noncopyable> (
-        "Learner",
-        "Train a classification model.", no_init)
-        .def ("train", &Learner::train)
-        .def ("train_given_weights", &Learner::train_given_weights)
-        ;
+const vector<int>&
+TrainingSample::sig_keep () const
+{
+    return m_sig_keep;
+}
 
-    register_ptr_to_python <boost::shared_ptr<Learner> > ();
+const vector<int>&
+TrainingSample::bg_keep () const
+{
+    return m_bg_keep;
 }
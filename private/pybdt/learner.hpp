@@ -7,10 +7,56 @@
 #include <vector>
 #include <string>
 
-#include "boost_python.hpp"
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
 
 #include "dataset.hpp"
 #include "model.hpp"
+#include "training_status.hpp"
+
+// The events and weights a Learner actually trains on: the input DataSets
+// projected onto the feature names, with non-finite events dropped.  The
+// projected DataSets are owned here, so the Events stay valid for the
+// lifetime of the TrainingSample.
+class TrainingSample : boost::noncopyable {
+public:
+
+    TrainingSample (const DataSet& sig, const DataSet& bg,
+                    const std::vector<std::string>& feature_names,
+                    const std::vector<double>& sig_weights,
+                    const std::vector<double>& bg_weights);
+
+    const std::vector<Event>& sig_events () const;
+    const std::vector<Event>& bg_events () const;
+    const std::vector<double>& sig_weights () const;
+    const std::vector<double>& bg_weights () const;
+
+    // indices of the kept events in the input DataSets
+    const std::vector<int>& sig_keep () const;
+    const std::vector<int>& bg_keep () const;
+
+private:
+
+    DataSet m_sig;
+    DataSet m_bg;
+    std::vector<int> m_sig_keep;
+    std::vector<int> m_bg_keep;
+    std::vector<Event> m_sig_events;
+    std::vector<Event> m_bg_events;
+    std::vector<double> m_sig_weights;
+    std::vector<double> m_bg_weights;
+
+};
+
+// The result of Learner::cross_validate.  Fold f holds out the events
+// whose index in the input DataSets is f modulo k; sig_scores and
+// bg_scores hold each event's score from the model that did not see it
+// (NaN for events dropped for non-finite values).
+struct CrossValidation {
+    std::vector<boost::shared_ptr<Model> > models;
+    std::vector<double> sig_scores;
+    std::vector<double> bg_scores;
+};
 
 class Learner {
 public:
@@ -26,38 +72,64 @@ public:
 
     virtual ~Learner ();
 
-    // structors for Python
-
-    explicit Learner (const boost::python::list& feature_names,
-                      const std::string& weight_name="");
-
-    Learner (const boost::python::list& feature_names,
-             const std::string& sig_weight_name,
-             const std::string& bg_weight_name);
-
     // inspectors
     std::vector<std::string> feature_names () const;
     std::string sig_weight_name () const;
     std::string bg_weight_name () const;
 
+    // called once as each top-level training (train, train_given_weights,
+    // cross_validate, ...) starts, before any model is trained; e.g.
+    // BDTLearner clears its training log.  Does nothing by default.
+    virtual void start_training () const;
+
     // factory methods
+    //
+    // if status is given, progress is reported to it and training stops
+    // with TrainingCancelled once it is cancelled
 
     boost::shared_ptr<Model> train (
-        const DataSet& sig, const DataSet& bg) const;
+        const DataSet& sig, const DataSet& bg,
+        TrainingStatus* status=0) const;
 
     boost::shared_ptr<Model> train_given_weights (
         const DataSet& sig, const DataSet& bg,
         const std::vector<double>& sig_weights,
-        const std::vector<double>& bg_weights) const;
+        const std::vector<double>& bg_weights,
+        TrainingStatus* status=0) const;
     
     virtual boost::shared_ptr<Model> train_given_everything (
         const std::vector<Event>& sig, const std::vector<Event>& bg,
         const std::vector<double>& init_sig_weights,
-        const std::vector<double>& init_bg_weights) const = 0;
+        const std::vector<double>& init_bg_weights,
+        TrainingStatus* status=0) const = 0;
+
+    // train_given_everything for one of several trainings run side by
+    // side, e.g. the folds of cross_validate: nothing is printed and
+    // nothing checkpointed, so that the trainings cannot garble each
+    // other's output or files, and anything logged is tagged with run.
+    // The default just calls train_given_everything, ignoring both quiet
+    // mode and run, so only learners that override this honour them
+    virtual boost::shared_ptr<Model> train_quietly (
+        const std::vector<Event>& sig, const std::vector<Event>& bg,
+        const std::vector<double>& init_sig_weights,
+        const std::vector<double>& init_bg_weights,
+        const std::string& run,
+        TrainingStatus* status=0) const;
+
+    // train k models, each on all but one fold of the events, on up to
+    // num_threads threads (num_threads <= 0 means one per core)
+    CrossValidation cross_validate (
+        const DataSet& sig, const DataSet& bg,
+        int k, int num_threads=0) const;
 
 
 protected:
 
+    // helpers
+
+    std::vector<double> initial_weights (
+        const DataSet& ds, const std::string& weight_name) const;
+
     // data members
 
     std::vector<std::string> m_feature_names;
@@ -70,6 +142,4 @@ private:
 
 };
 
-void export_learner ();
-
 #endif  /* PYBDT_LEARNER_HPP */
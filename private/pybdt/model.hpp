@@ -10,8 +10,6 @@
 
 #include <boost/shared_ptr.hpp>
 
-#include "boost_python.hpp"
-
 #include "dataset.hpp"
 
 
@@ -30,20 +28,16 @@ public:
 };
 
 class Model {
-    friend class DTModel_pickle_suite;
-    friend class BDTModel_pickle_suite;
 public:
 
     // structors
 
     Model (std::vector<std::string> feature_names);
-    Model (boost::python::list feature_names);
     virtual ~Model ();
 
     // inspectors
 
     std::vector<std::string> feature_names () const;
-    boost::python::list feature_names_py () const;
 
     // score methods
     double score (const Scoreable& s,
@@ -57,25 +51,20 @@ public:
                                bool use_purity=false,
                                bool quiet=false);
 
-    // score methods for use from Python
-    double score_one (const boost::python::list& vals,
-                      bool use_purity);
-    PyObject* score_DataSet (const DataSet& ds,
-                             bool use_purity,
-                             bool quiet);
-
-
 protected:
 
     virtual double base_score (const Scoreable& s,
                                bool use_purity) const = 0;
 
+    // score a batch of events, NaN for events with non-finite features;
+    // the default scores them one at a time
+    virtual std::vector<double> base_scores (
+        const std::vector<Event>& events, bool use_purity, bool quiet) const;
+
     std::vector<std::string> m_feature_names;
     int m_n_features;
 };
 
-void export_model ();
-
 
 
 template <typename EventType>
@@ -0,0 +1,116 @@
+// parallel.hpp
+// run independent jobs on a pool of threads
+
+
+#ifndef PYBDT_PARALLEL_HPP
+#define PYBDT_PARALLEL_HPP
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+
+namespace parallel {
+
+// number of threads to use when num_threads <= 0 is requested
+inline int
+default_num_threads ()
+{
+    const int n (boost::thread::hardware_concurrency ());
+    return n > 0 ? n : 1;
+}
+
+template <typename Func>
+class ParallelFor {
+public:
+
+    ParallelFor (int n, Func& func)
+        : m_n (n), m_next (0), m_func (func)
+    { }
+
+    void work ()
+    {
+        for (;;) {
+            int i;
+            {
+                boost::mutex::scoped_lock lock (m_mutex);
+                if (m_next >= m_n or not m_error.empty ()) {
+                    return;
+                }
+                i = m_next++;
+            }
+            try {
+                m_func (i);
+            }
+            catch (const std::exception& e) {
+                fail (e.what ());
+            }
+            catch (...) {
+                fail ("unknown error");
+            }
+        }
+    }
+
+    const std::string& error () const
+    {
+        return m_error;
+    }
+
+private:
+
+    void fail (const std::string& what)
+    {
+        boost::mutex::scoped_lock lock (m_mutex);
+        if (m_error.empty ()) {
+            m_error = what.empty () ? "unknown error" : what;
+        }
+    }
+
+    const int m_n;
+    int m_next;
+    Func& m_func;
+    boost::mutex m_mutex;
+    std::string m_error;
+
+};
+
+// Call func (i) for every i in [0, n), on up to num_threads threads
+// (num_threads <= 0 means one per core).  Jobs are handed out in order of
+// i.  If any job throws, no further jobs are started and a
+// std::runtime_error with the first error message is thrown once the
+// running jobs have finished.
+template <typename Func>
+void
+parallel_for (int n, int num_threads, Func& func)
+{
+    if (num_threads <= 0) {
+        num_threads = default_num_threads ();
+    }
+    if (num_threads > n) {
+        num_threads = n;
+    }
+    ParallelFor<Func> pf (n, func);
+    if (num_threads <= 1) {
+        pf.work ();
+    }
+    else {
+        boost::thread_group threads;
+        for (int i_thread (0); i_thread < num_threads; ++i_thread) {
+            threads.create_thread (
+                boost::bind (&ParallelFor<Func>::work, &pf));
+        }
+        threads.join_all ();
+    }
+    if (not pf.error ().empty ()) {
+        throw std::runtime_error (pf.error ());
+    }
+}
+
+}
+
+
+#endif  /* PYBDT_PARALLEL_HPP */
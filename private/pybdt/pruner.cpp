@@ -1,9 +1,8 @@
 // pruner.cpp
 
-#include <Python.h>
-
 #include "pruner.hpp"
 
+#include <limits>
 #include <map>
 #include <numeric>
 #include <queue>
@@ -11,7 +10,6 @@
 
 using namespace std;
 using namespace boost;
-namespace py = boost::python;
 
 
 // Pruner -----------------------------------------------------------
@@ -210,32 +208,44 @@ ErrorPruner::~ErrorPruner ()
 void
 ErrorPruner::prune (boost::shared_ptr<DTModel> tree)
 {
-    typedef vector<boost::shared_ptr<DTNode> > nodelist;
-    nodelist prune_sequence (get_prune_sequence (tree->root ()));
-    for (nodelist::size_type i_prune (0);
-         i_prune < prune_sequence.size (); ++i_prune) {
-        prune_sequence[i_prune]->prune ();
+    bool prune_root;
+    prune_node (tree->root (), prune_root);
+    if (prune_root) {
+        tree->root ()->prune ();
     }
 }
 
-vector<boost::shared_ptr<DTNode> >
-ErrorPruner::get_prune_sequence (boost::shared_ptr<DTNode> node)
+// Each node is compared against its unpruned subtree, so the errors of
+// the children are those from before any pruning below them.  A node
+// prunes its children in place once it is itself kept; an ancestor may
+// still prune that node later, which wastes the children's prune () but
+// gives the same tree.
+double
+ErrorPruner::prune_node (const boost::shared_ptr<DTNode>& node,
+                         bool& prune_here)
 {
-    typedef vector<boost::shared_ptr<DTNode> > nodelist;
-    nodelist out;
-    out.reserve (node->tree_size ());
-    if (not node->is_leaf ()) {
-        vector<boost::shared_ptr<DTNode> > left_seq (
-            get_prune_sequence (node->left ()));
-        vector<boost::shared_ptr<DTNode> > right_seq (
-            get_prune_sequence (node->right ()));
-        out.insert (out.end (), left_seq.begin (), left_seq.end ());
-        out.insert (out.end (), right_seq.begin (), right_seq.end ());
-        if (subtree_error (node) >= node_error (node)) {
-            out.push_back (node);
+    if (node->is_leaf ()) {
+        prune_here = false;
+        return node_error (node);
+    }
+    const boost::shared_ptr<DTNode> left (node->left ());
+    const boost::shared_ptr<DTNode> right (node->right ());
+    bool prune_left, prune_right;
+    const double left_error (prune_node (left, prune_left));
+    const double right_error (prune_node (right, prune_right));
+    const double error (
+        (left->w_total () * left_error + right->w_total () * right_error)
+        / node->w_total ());
+    prune_here = error >= node_error (node);
+    if (not prune_here) {
+        if (prune_left) {
+            left->prune ();
+        }
+        if (prune_right) {
+            right->prune ();
         }
     }
-    return out;
+    return error;
 }
 
 double
@@ -274,49 +284,3 @@ ErrorPruner::strength (double s)
 {
     m_strength = s;
 }
-
-
-void
-export_pruners ()
-{
-    using namespace boost::python;
-    class_<Pruner, boost::noncopyable> (
-        "Pruner",
-        no_init)
-        .def ("prune", &Pruner::prune)
-        ;
-
-    class_<SameLeafPruner, bases<Pruner> > (
-        "SameLeafPruner",
-        init<> ())
-        ;
-
-    class_<CostComplexityPruner, bases<Pruner> > (
-        "CostComplexityPruner",
-        init<double> ())
-        .add_property (
-            "strength", 
-            (double (CostComplexityPruner::*)()const)
-            &CostComplexityPruner::strength,
-            (void (CostComplexityPruner::*)(double))
-            &CostComplexityPruner::strength)
-        .def ("gain", &CostComplexityPruner::gain).staticmethod ("gain")
-        .def ("rho", &CostComplexityPruner::rho).staticmethod ("rho")
-        ;
-
-    class_<ErrorPruner, bases<Pruner> > (
-        "ErrorPruner",
-        init<double> ())
-        .add_property (
-            "strength", 
-            (double (ErrorPruner::*)()const) &ErrorPruner::strength,
-            (void (ErrorPruner::*)(double)) &ErrorPruner::strength)
-        .def ("subtree_error", &ErrorPruner::subtree_error)
-        .def ("node_error", &ErrorPruner::node_error)
-        ;
-
-    register_ptr_to_python <boost::shared_ptr<Pruner> > ();
-    register_ptr_to_python <boost::shared_ptr<SameLeafPruner> > ();
-    register_ptr_to_python <boost::shared_ptr<CostComplexityPruner> > ();
-    register_ptr_to_python <boost::shared_ptr<ErrorPruner> > ();
-}
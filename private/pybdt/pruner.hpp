@@ -60,12 +60,12 @@ public:
     void strength (double s);
 
 private:
-    std::vector<boost::shared_ptr<DTNode> > get_prune_sequence (
-        boost::shared_ptr<DTNode> node);
+    // one post-order pass: returns subtree_error (node) and sets
+    // prune_here if node should be pruned
+    double prune_node (const boost::shared_ptr<DTNode>& node,
+                       bool& prune_here);
     double m_strength;
 };
 
 
-void export_pruners ();
-
 #endif  /* PYBDT_PRUNER_HPP */
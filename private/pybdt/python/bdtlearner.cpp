@@ -0,0 +1,248 @@
+// bdtlearner.cpp
+// Python bindings for BDTLearner
+
+#include "convert.hpp"
+#include "export.hpp"
+#include "gil.hpp"
+
+#include "bdtlearner.hpp"
+
+
+using namespace std;
+using namespace boost;
+namespace py = boost::python;
+
+
+static boost::shared_ptr<Model>
+resume_py (const BDTLearner& learner, const DataSet& sig, const DataSet& bg)
+{
+    ReleaseGIL nogil;
+    return learner.resume (sig, bg);
+}
+
+// BDTLearner.train_grid: configs maps a name to a dict of option overrides
+static py::dict
+train_grid_py (const BDTLearner& learner,
+               const DataSet& sig, const DataSet& bg,
+               const py::dict& configs, int num_threads)
+{
+    const py::list names (configs.keys ());
+    const int n_configs (len (names));
+    vector<BDTConfig> grid;
+    grid.reserve (n_configs);
+    for (int i (0); i < n_configs; ++i) {
+        BDTConfig config (learner.config ());
+        config.run = py::extract<string> (py::str (py::object (names[i])));
+        const py::dict options = py::extract<py::dict> (configs[names[i]]);
+        const py::list keys (options.keys ());
+        for (int j (0); j < len (keys); ++j) {
+            const string key = py::extract<string> (keys[j]);
+            const py::object value (options[keys[j]]);
+            if (key == "beta") {
+                config.beta = py::extract<double> (value);
+            }
+            else if (key == "boost_type") {
+                config.boost_type = py::extract<string> (value);
+                if (config.boost_type != "adaboost"
+                    and config.boost_type != "newton") {
+                    throw std::runtime_error (
+                        "unknown boost type \"" + config.boost_type + "\"");
+                }
+            }
+            else if (key == "l2") {
+                config.l2 = py::extract<double> (value);
+            }
+            else if (key == "learning_rate") {
+                config.learning_rate = py::extract<double> (value);
+            }
+            else if (key == "frac_random_events") {
+                config.frac_random_events = py::extract<double> (value);
+            }
+            else if (key == "goss_rest") {
+                config.goss_rest = py::extract<double> (value);
+            }
+            else if (key == "goss_top") {
+                config.goss_top = py::extract<double> (value);
+            }
+            else if (key == "sampling") {
+                config.sampling = py::extract<string> (value);
+                BDTLearner::check_sampling (config.sampling);
+            }
+            else if (key == "num_trees") {
+                config.num_trees = py::extract<int> (value);
+            }
+            else if (key == "seed") {
+                config.seed = py::extract<int> (value);
+            }
+            else if (key == "linear_cuts") {
+                config.dt.linear_cuts = py::extract<bool> (value);
+            }
+            else if (key == "max_depth") {
+                config.dt.max_depth = py::extract<int> (value);
+            }
+            else if (key == "min_split") {
+                config.dt.min_split = py::extract<int> (value);
+            }
+            else if (key == "num_cuts") {
+                config.dt.num_cuts = py::extract<int> (value);
+            }
+            else if (key == "num_random_variables") {
+                config.dt.num_random_variables = py::extract<int> (value);
+            }
+            else {
+                throw std::runtime_error (
+                    "unknown train_grid option \"" + key + "\"");
+            }
+        }
+        grid.push_back (config);
+    }
+    vector<boost::shared_ptr<Model> > models;
+    {
+        ReleaseGIL nogil;
+        models = learner.train_grid (sig, bg, grid, num_threads);
+    }
+    py::dict out;
+    for (int i (0); i < n_configs; ++i) {
+        out[names[i]] = models[i];
+    }
+    return out;
+}
+
+static py::list
+bdtlearner_after_pruners (const BDTLearner& learner)
+{
+    return np::vector_to_list (learner.after_pruners ());
+}
+
+static py::list
+bdtlearner_before_pruners (const BDTLearner& learner)
+{
+    return np::vector_to_list (learner.before_pruners ());
+}
+
+void
+export_bdtlearner ()
+{
+    using namespace boost::python;
+    class_<Booster> (
+        "Booster",
+        init<bool,double,double> ());
+
+    class_<BDTLearner, bases<Learner> > (
+        "BDTLearner",
+        "Train a boosted decision tree.\n\n"
+        "The feature_names, sig_weight_name and bg_weight_name are chosen\n"
+        "at construction and are intrinsic to each BDTLearner.  After\n"
+        "construction, various options can be set and one or more\n"
+        "boosted decision trees can be be trained.  Each training\n"
+        "results in a new Model object."
+        ,no_init)
+        .def ("__init__", make_constructor (&make_learner<BDTLearner>))
+        .def ("__init__", make_constructor (&make_learner_w<BDTLearner>))
+        .def ("__init__", make_constructor (&make_learner_sb<BDTLearner>))
+        .add_property (
+            "dtlearner", &BDTLearner::dtlearner)
+        .add_property (
+            "beta",
+            (double (BDTLearner::*)()const) &BDTLearner::beta,
+            (void (BDTLearner::*)(double)) &BDTLearner::beta)
+        .add_property (
+            "boost_type",
+            (string (BDTLearner::*)()const) &BDTLearner::boost_type,
+            (void (BDTLearner::*)(const string&)) &BDTLearner::boost_type)
+        .add_property (
+            "checkpoint_filename",
+            (string (BDTLearner::*)()const) &BDTLearner::checkpoint_filename,
+            (void (BDTLearner::*)(const string&))
+            &BDTLearner::checkpoint_filename)
+        .add_property (
+            "checkpoint_interval",
+            (int (BDTLearner::*)()const) &BDTLearner::checkpoint_interval,
+            (void (BDTLearner::*)(int)) &BDTLearner::checkpoint_interval)
+        .add_property (
+            "frac_random_events",
+            (double (BDTLearner::*)()const) &BDTLearner::frac_random_events,
+            (void (BDTLearner::*)(double)) &BDTLearner::frac_random_events)
+        .add_property (
+            "goss_rest",
+            (double (BDTLearner::*)()const) &BDTLearner::goss_rest,
+            (void (BDTLearner::*)(double)) &BDTLearner::goss_rest,
+            "With sampling \"goss\", the fraction of all events drawn\n"
+            "from those outside the top goss_top.")
+        .add_property (
+            "goss_top",
+            (double (BDTLearner::*)()const) &BDTLearner::goss_top,
+            (void (BDTLearner::*)(double)) &BDTLearner::goss_top,
+            "With sampling \"goss\", the fraction of events with the\n"
+            "largest weight (adaboost) or gradient (newton) always kept.")
+        .add_property (
+            "l2",
+            (double (BDTLearner::*)()const) &BDTLearner::l2,
+            (void (BDTLearner::*)(double)) &BDTLearner::l2)
+        .add_property (
+            "learning_rate",
+            (double (BDTLearner::*)()const) &BDTLearner::learning_rate,
+            (void (BDTLearner::*)(double)) &BDTLearner::learning_rate)
+        .add_property (
+            "num_trees", 
+            (int (BDTLearner::*)()const) &BDTLearner::num_trees,
+            (void (BDTLearner::*)(int)) &BDTLearner::num_trees)
+        .add_property (
+            "quantile_sketch_threshold",
+            (int (BDTLearner::*)()const)
+            &BDTLearner::quantile_sketch_threshold,
+            (void (BDTLearner::*)(int))
+            &BDTLearner::quantile_sketch_threshold)
+        .add_property (
+            "quiet", 
+            (bool (BDTLearner::*)()const) &BDTLearner::quiet,
+            (void (BDTLearner::*)(bool)) &BDTLearner::quiet)
+        .add_property (
+            "sampling",
+            (string (BDTLearner::*)()const) &BDTLearner::sampling,
+            (void (BDTLearner::*)(const string&)) &BDTLearner::sampling,
+            "How each tree's events are picked: \"uniform\" bags\n"
+            "frac_random_events of them uniformly; \"weighted\" draws\n"
+            "that many in proportion to the current boosting weights;\n"
+            "\"goss\" keeps the goss_top fraction with the largest\n"
+            "weights or gradients plus goss_rest of the others.")
+        .add_property (
+            "training_log", &BDTLearner::training_log)
+        .add_property (
+            "profile", &BDTLearner::profile,
+            "TrainingProfile of the trainings since profiling was\n"
+            "enabled, or None.")
+        .add_property (
+            "profiling",
+            (bool (BDTLearner::*)()const) &BDTLearner::profiling,
+            (void (BDTLearner::*)(bool)) &BDTLearner::profiling)
+        .add_property (
+            "after_pruners", &bdtlearner_after_pruners)
+        .add_property (
+            "before_pruners", &bdtlearner_before_pruners)
+        .def ("add_after_pruner", &BDTLearner::add_before_pruner)
+        .def ("add_before_pruner", &BDTLearner::add_before_pruner)
+        .def ("clear_after_pruners", &BDTLearner::clear_after_pruners)
+        .def ("clear_before_pruners", &BDTLearner::clear_before_pruners)
+        .def ("set_defaults", &BDTLearner::set_defaults)
+        .def ("train_grid", &train_grid_py,
+              "Train one model per entry of configs on up to num_threads\n"
+              "threads (0: one per core).\n\n"
+              "configs maps names to dicts overriding any of beta,\n"
+              "boost_type, l2, learning_rate,\n"
+              "frac_random_events, goss_rest, goss_top, sampling,\n"
+              "num_trees, seed, linear_cuts,\n"
+              "max_depth, min_split, num_cuts and num_random_variables.\n"
+              "The events are projected and filtered once and shared by\n"
+              "all trainings, which print no progress and write no\n"
+              "checkpoints.  Returns a dict mapping the same names to the\n"
+              "trained models.")
+        .def ("resume", &resume_py,
+              "Continue the training saved in checkpoint_filename.\n\n"
+              "sig and bg must be the DataSets the interrupted training\n"
+              "was started with.")
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<BDTLearner> > ();
+    register_ptr_to_python <boost::shared_ptr<Booster> > ();
+}
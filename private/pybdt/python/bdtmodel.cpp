@@ -0,0 +1,103 @@
+// bdtmodel.cpp
+// Python bindings for BDTModel
+
+#include "convert.hpp"
+#include "export.hpp"
+#include "gil.hpp"
+
+#include "bdtmodel.hpp"
+#include "pruner.hpp"
+
+#include <boost/make_shared.hpp>
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+namespace py = boost::python;
+
+
+struct BDTModel_pickle_suite : py::pickle_suite {
+    static
+    py::tuple getinitargs (const BDTModel& m)
+    {
+        py::list dtmodels;
+        py::list alphas;
+        for (int i (0); i < m.n_dtmodels (); ++i) {
+            dtmodels.append (m.get_dtmodel (i));
+            alphas.append (m.get_alpha (i));
+        }
+        return py::make_tuple (
+            np::vector_to_list (m.feature_names ()), dtmodels, alphas);
+    }
+};
+
+static boost::shared_ptr<BDTModel>
+bdtmodel_from_lists (const py::list& feature_names,
+                     const py::list& dtmodels,
+                     const py::list& alphas)
+{
+    return boost::make_shared<BDTModel> (
+        np::list_to_vector<string> (feature_names),
+        np::list_to_vector<boost::shared_ptr<DTModel> > (dtmodels),
+        np::list_to_vector<double> (alphas));
+}
+
+static py::dict
+bdtmodel_event_variable_importance (
+    const BDTModel& m, const py::list& vals,
+    bool sep_weighted, bool tree_weighted)
+{
+    return feature_dict (m, m.event_variable_importance (
+            make_scoreable (np::list_to_vector<double> (vals)),
+            sep_weighted, tree_weighted));
+}
+
+static py::dict
+bdtmodel_variable_importance (
+    const BDTModel& m, bool sep_weighted, bool tree_weighted)
+{
+    return feature_dict (
+        m, m.variable_importance (sep_weighted, tree_weighted));
+}
+
+static boost::shared_ptr<BDTModel>
+bdtmodel_get_subset_bdtmodel_list (const BDTModel& m, py::list indices)
+{
+    return m.get_subset_bdtmodel_list (np::list_to_vector<int> (indices));
+}
+
+static boost::shared_ptr<BDTModel>
+bdtmodel_pruned (const BDTModel& m, boost::shared_ptr<Pruner> pruner,
+                 int num_threads)
+{
+    ReleaseGIL nogil;
+    return m.pruned (pruner, num_threads);
+}
+
+void
+export_bdtmodel ()
+{
+    class_<BDTModel, bases<Model> > (
+        "BDTModel", no_init)
+        .def ("__init__", make_constructor (&bdtmodel_from_lists))
+        .def ("get_alpha", &BDTModel::get_alpha)
+        .def ("get_dtmodel", &BDTModel::get_dtmodel)
+        .def ("get_subset_bdtmodel", &BDTModel::get_subset_bdtmodel)
+        .def ("get_subset_bdtmodel_list", &bdtmodel_get_subset_bdtmodel_list)
+        .def ("get_trimmed_bdtmodel", &BDTModel::get_trimmed_bdtmodel)
+        .def ("pruned", &bdtmodel_pruned,
+              (py::arg ("pruner"), py::arg ("num_threads")=0),
+              "Return a new BDTModel whose trees are copies of these,\n"
+              "pruned by pruner on up to num_threads threads (0: one per\n"
+              "core).  This model is not changed.")
+        .def ("event_variable_importance",
+              &bdtmodel_event_variable_importance)
+        .def ("variable_importance",
+              &bdtmodel_variable_importance)
+        .add_property ("n_dtmodels", &BDTModel::n_dtmodels)
+        .def_pickle (BDTModel_pickle_suite ())
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<BDTModel> > ();
+}
@@ -0,0 +1,77 @@
+// convert.hpp
+// conversions between std::vector and Python lists and numpy arrays
+
+#ifndef PYBDT_CONVERT_HPP
+#define PYBDT_CONVERT_HPP
+
+#include <vector>
+
+#include "boost_python.hpp"
+
+#define PY_ARRAY_UNIQUE_SYMBOL pybdt_ARRAY_API
+#define NO_IMPORT_ARRAY
+
+#include <numpy/ndarrayobject.h>
+
+namespace np {
+
+using namespace std;
+using namespace boost::python;
+
+template <typename T>
+vector<T>
+array_to_vector (PyObject* a)
+{
+    int N = PyArray_Size (a);
+    vector<T> out (N);
+    for (int i = 0; i < N; ++i) {
+        out[i] = T (*((T *) PyArray_GETPTR1 (a, i)));
+    }
+    return out;
+}
+
+template <typename T>
+std::vector<T>
+list_to_vector (const boost::python::list& l)
+{
+    int N = len (l);
+    vector<T> out (N);
+    for (int i = 0; i < N; ++i) {
+        out[i] = extract<T> (l[i]);
+    }
+    return out;
+}
+
+template <typename T>
+boost::python::list
+vector_to_list (const vector<T>& v)
+{
+    typedef typename std::vector<T>::const_iterator citer;
+    boost::python::list out;
+    for (citer i = v.begin (); i != v.end (); ++i) {
+        out.append (*i);
+    }
+    return out;
+}
+
+template <typename T>
+PyObject*
+vector_to_array (const vector<T>& v)
+{
+    typedef typename std::vector<T>::size_type size_type;
+    size_type N (v.size ());
+    npy_intp dims[1];
+    dims[0] = N;
+    PyObject* C_a (PyArray_SimpleNew (1, dims, NPY_FLOAT64));
+    for (size_type i(0); i < N; ++i) {
+        double* dest ((double*) PyArray_GETPTR1 (C_a, i));
+        *dest = v[i];
+    }
+    return C_a;
+}
+
+
+}
+
+
+#endif  // PYBDT_CONVERT_HPP
@@ -0,0 +1,99 @@
+// dataset.cpp
+// Python bindings for DataSet
+
+#include "convert.hpp"
+#include "export.hpp"
+
+#include "dataset.hpp"
+
+#include <boost/make_shared.hpp>
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+namespace py = boost::python;
+
+
+// data should be a dict of (str, numpy.ndarray) items, plus optionally
+// a float "livetime"; columns are sorted by name
+static boost::shared_ptr<DataSet>
+dataset_from_dict (const py::dict& data, const string& subset)
+{
+    double livetime (-1);
+    py::list keys = data.keys ();
+    keys.sort ();
+    vector<string> names;
+    vector<vector<double> > cols;
+    for (int j = 0; j < len (keys); ++j) {
+        string name = extract<string> (keys[j]);
+        if (name == "livetime") {
+            livetime = extract<double> (data[name]);
+            continue;
+        }
+        py::object pycol = data[name];
+        PyObject* C_numpy_col = pycol.ptr ();
+        if (not PyArray_Check (C_numpy_col)) {
+            continue;
+        }
+        names.push_back (name);
+        // n.b.: C_numpy_col had better consist of floats!
+        // (pure-Python wrapper layer ensures this)
+        cols.push_back (np::array_to_vector<double> (C_numpy_col));
+    }
+    return boost::make_shared<DataSet> (names, cols, livetime, subset);
+}
+
+static boost::shared_ptr<DataSet>
+dataset_from_dict_all (const py::dict& data)
+{
+    return dataset_from_dict (data, "all");
+}
+
+static PyObject*
+dataset_getitem (const DataSet& ds, const string& name)
+{
+    return np::vector_to_array (ds.get_column (name));
+}
+
+static py::list
+dataset_names (const DataSet& ds)
+{
+    return np::vector_to_list (ds.names ());
+}
+
+static py::dict
+dataset_to_dict (const DataSet& ds)
+{
+    dict out;
+    const vector<string> names (ds.names ());
+    for (vector<string>::const_iterator i_name = names.begin ();
+         i_name != names.end (); ++i_name) {
+        out[*i_name] = object (handle<> (dataset_getitem (ds, *i_name)));
+    }
+    return out;
+}
+
+void
+export_dataset ()
+{
+
+    class_<DataSet> (
+        "DataSet",
+         no_init)
+        .def ("__init__", make_constructor (&dataset_from_dict_all))
+        .def ("__init__", make_constructor (&dataset_from_dict))
+        .def ("get_column", &DataSet::get_column)
+        .def ("to_dict", &dataset_to_dict)
+        .def ("__getitem__", &dataset_getitem)
+        .def ("__len__", &DataSet::n_events)
+        .add_property ("n_features", &DataSet::n_features)
+        .add_property ("n_events", &DataSet::n_events)
+        .add_property ("names", &dataset_names)
+        .add_property (
+            "livetime",
+            (double (DataSet::*)()const) &DataSet::livetime,
+            (void (DataSet::*)(double)) &DataSet::livetime)
+        // .def_pickle (DataSet_pickle_suite ())
+        ;
+}
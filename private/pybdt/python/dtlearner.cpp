@@ -0,0 +1,86 @@
+// dtlearner.cpp
+// Python bindings for DTLearner and RegLearner
+
+#include "convert.hpp"
+#include "export.hpp"
+
+#include "dtlearner.hpp"
+
+
+using namespace std;
+using namespace boost;
+namespace py = boost::python;
+
+
+// RegLearner has always defaulted to cross_entropy when built from Python
+static boost::shared_ptr<RegLearner>
+reglearner_from_list (const py::list& feature_names,
+                      const string& sig_weight_name,
+                      const string& bg_weight_name)
+{
+    boost::shared_ptr<RegLearner> learner (
+        make_learner_sb<RegLearner> (
+            feature_names, sig_weight_name, bg_weight_name));
+    learner->separation_type ("cross_entropy");
+    return learner;
+}
+
+void
+export_dtlearner ()
+{
+    using namespace boost::python;
+   
+    class_<DTLearner, bases<Learner> > (
+        "DTLearner",
+        "Train a single decision tree."
+        ,no_init)
+        .def ("__init__", make_constructor (&make_learner<DTLearner>))
+        .def ("__init__", make_constructor (&make_learner_w<DTLearner>))
+        .def ("__init__", make_constructor (&make_learner_sb<DTLearner>))
+        .def ("set_defaults", &DTLearner::set_defaults)
+        .add_property (
+            "linear_cuts", 
+            (bool (DTLearner::*)()const) &DTLearner::linear_cuts,
+            (void (DTLearner::*)(bool)) &DTLearner::linear_cuts)
+        .add_property (
+            "max_depth", 
+            (int (DTLearner::*)()const) &DTLearner::max_depth,
+            (void (DTLearner::*)(int)) &DTLearner::max_depth)
+        .add_property (
+            "min_split", 
+            (int (DTLearner::*)()const) &DTLearner::min_split,
+            (void (DTLearner::*)(int)) &DTLearner::min_split)
+        .add_property (
+            "num_cuts", 
+            (int (DTLearner::*)()const) &DTLearner::num_cuts,
+            (void (DTLearner::*)(int)) &DTLearner::num_cuts)
+        .add_property (
+            "num_random_variables",
+            (int (DTLearner::*)()const) &DTLearner::num_random_variables,
+            (void (DTLearner::*)(int)) &DTLearner::num_random_variables)
+        .add_property (
+            "profile", &DTLearner::profile,
+            "TrainingProfile of the trainings since profiling was\n"
+            "enabled, or None.")
+        .add_property (
+            "profiling",
+            (bool (DTLearner::*)()const) &DTLearner::profiling,
+            (void (DTLearner::*)(bool)) &DTLearner::profiling)
+        .add_property (
+            "seed",
+            (int (DTLearner::*)()const) &DTLearner::seed,
+            (void (DTLearner::*)(int)) &DTLearner::seed)
+        .add_property (
+            "separation_type",
+            (std::string (DTLearner::*)()const)&DTLearner::separation_type,
+            (void (DTLearner::*)(std::string)) &DTLearner::separation_type)
+        ;
+        class_<RegLearner,bases<DTLearner> >(
+        "RegLearner",
+        "Train a single regression tree."
+        ,no_init)
+        .def ("__init__", make_constructor (&reglearner_from_list))
+        ;
+    register_ptr_to_python <boost::shared_ptr<DTLearner> > ();
+    register_ptr_to_python <boost::shared_ptr<RegLearner> > ();
+}
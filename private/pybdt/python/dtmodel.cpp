@@ -0,0 +1,122 @@
+// dtmodel.cpp
+// Python bindings for DTNode and DTModel
+
+#include "convert.hpp"
+#include "export.hpp"
+
+#include "dtmodel.hpp"
+
+#include <boost/make_shared.hpp>
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+namespace py = boost::python;
+
+
+struct DTNode_pickle_suite : py::pickle_suite {
+    static
+    py::tuple getinitargs (const DTNode& n)
+    {
+        return py::make_tuple (
+            n.sep_gain (), n.sep_index (), n.feature_id (), n.feature_val (),
+            n.w_sig (), n.w_bg (),
+            int (n.n_sig ()), int (n.n_bg ()),
+            n.left (), n.right ());
+    }
+
+    static
+    py::tuple getstate (const DTNode& n)
+    {
+        return py::make_tuple (n.response ());
+    }
+
+    static
+    void setstate (DTNode& n, py::tuple state)
+    {
+        n.response (py::extract<double> (state[0]));
+    }
+};
+
+struct DTModel_pickle_suite : py::pickle_suite {
+    static
+    py::tuple getinitargs (const DTModel& m)
+    {
+        return py::make_tuple (
+            np::vector_to_list (m.feature_names ()), m.root ());
+    }
+};
+
+static boost::shared_ptr<DTModel>
+dtmodel_from_list (const py::list& feature_names,
+                   boost::shared_ptr<DTNode> root)
+{
+    return boost::make_shared<DTModel> (
+        np::list_to_vector<string> (feature_names), root);
+}
+
+static py::dict
+dtmodel_event_variable_importance (
+    const DTModel& m, const py::list& vals, bool sep_weighted)
+{
+    return feature_dict (m, m.event_variable_importance (
+            make_scoreable (np::list_to_vector<double> (vals)),
+            sep_weighted));
+}
+
+static py::dict
+dtmodel_variable_importance (const DTModel& m, bool sep_weighted)
+{
+    return feature_dict (m, m.variable_importance (sep_weighted));
+}
+
+void
+export_dtmodel ()
+{
+    class_<DTNode> (
+        "DTNode",
+        "A decision tree node.  A node belongs to a single tree, so\n"
+        "children passed to the constructor that already have a parent\n"
+        "are deep copied rather than shared.",
+        init<double,double,int,double,double,double,int,int,
+        boost::shared_ptr<DTNode>,boost::shared_ptr<DTNode> >())
+        .add_property ("feature_id", &DTNode::feature_id)
+        .add_property ("feature_name", &DTNode::feature_name)
+        .add_property ("feature_val", &DTNode::feature_val)
+        .add_property ("is_leaf", &DTNode::is_leaf)
+        .add_property ("left", &DTNode::left)
+        .add_property ("max_depth", &DTNode::max_depth)
+        .add_property ("n_bg", &DTNode::n_bg)
+        .add_property ("n_leaves", &DTNode::n_leaves)
+        .add_property ("n_sig", &DTNode::n_sig)
+        .add_property ("n_total", &DTNode::n_total)
+        .add_property ("purity", &DTNode::purity)
+        .add_property ("response",
+                       (double (DTNode::*)()const) &DTNode::response)
+        .add_property ("right", &DTNode::right)
+        .add_property ("sep_gain", &DTNode::sep_gain)
+        .add_property ("sep_index", &DTNode::sep_gain)
+        .add_property ("tree_size", &DTNode::tree_size)
+        .add_property ("w_bg", &DTNode::w_bg)
+        .add_property ("w_sig", &DTNode::w_sig)
+        .add_property ("w_total", &DTNode::w_total)
+        .def ("prune", &DTNode::prune)
+        .def_pickle (DTNode_pickle_suite ())
+        ;
+
+
+    class_<DTModel, bases<Model> > (
+        "DTModel", no_init)
+        .def ("__init__", make_constructor (&dtmodel_from_list))
+        .def ("event_variable_importance",
+              &dtmodel_event_variable_importance)
+        .def ("variable_importance",
+              &dtmodel_variable_importance)
+        .add_property ("root", &DTModel::root)
+        .def_pickle (DTModel_pickle_suite ())
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<DTNode> > ();
+    register_ptr_to_python <boost::shared_ptr<DTModel> > ();
+}
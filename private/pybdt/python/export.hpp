@@ -0,0 +1,73 @@
+// export.hpp
+// the Python bindings, one export function per core module
+
+
+#ifndef PYBDT_EXPORT_HPP
+#define PYBDT_EXPORT_HPP
+
+#include <string>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "boost_python.hpp"
+#include "convert.hpp"
+
+#include "model.hpp"
+
+
+void export_dataset ();
+void export_model ();
+void export_dtmodel ();
+void export_bdtmodel ();
+void export_gbmodel ();
+void export_vinemodel ();
+void export_learner ();
+void export_dtlearner ();
+void export_bdtlearner ();
+void export_vinelearner ();
+void export_pruners ();
+void export_training_handle ();
+void export_training_log ();
+void export_training_profile ();
+
+
+// dict mapping the model's feature names to values
+boost::python::dict feature_dict (const Model& model,
+                                  const std::vector<double>& values);
+
+
+// Learner constructors taking the feature names as a Python list, for use
+// with boost::python::make_constructor
+
+template <typename LearnerType>
+boost::shared_ptr<LearnerType>
+make_learner (const boost::python::list& feature_names)
+{
+    return boost::make_shared<LearnerType> (
+        np::list_to_vector<std::string> (feature_names));
+}
+
+template <typename LearnerType>
+boost::shared_ptr<LearnerType>
+make_learner_w (const boost::python::list& feature_names,
+                const std::string& weight_name)
+{
+    return boost::make_shared<LearnerType> (
+        np::list_to_vector<std::string> (feature_names), weight_name);
+}
+
+template <typename LearnerType>
+boost::shared_ptr<LearnerType>
+make_learner_sb (const boost::python::list& feature_names,
+                 const std::string& sig_weight_name,
+                 const std::string& bg_weight_name)
+{
+    return boost::make_shared<LearnerType> (
+        np::list_to_vector<std::string> (feature_names),
+        sig_weight_name, bg_weight_name);
+}
+
+
+#endif  /* PYBDT_EXPORT_HPP */
@@ -0,0 +1,55 @@
+// gbmodel.cpp
+// Python bindings for GBModel
+
+#include "convert.hpp"
+#include "export.hpp"
+
+#include "gbmodel.hpp"
+
+#include <boost/make_shared.hpp>
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+namespace py = boost::python;
+
+
+struct GBModel_pickle_suite : py::pickle_suite {
+    static
+    py::tuple getinitargs (const GBModel& m)
+    {
+        py::list dtmodels;
+        for (int i (0); i < m.n_dtmodels (); ++i) {
+            dtmodels.append (m.get_dtmodel (i));
+        }
+        return py::make_tuple (
+            np::vector_to_list (m.feature_names ()), dtmodels, m.f0 ());
+    }
+};
+
+static boost::shared_ptr<GBModel>
+gbmodel_from_lists (const py::list& feature_names,
+                    const py::list& dtmodels,
+                    double f0)
+{
+    return boost::make_shared<GBModel> (
+        np::list_to_vector<string> (feature_names),
+        np::list_to_vector<boost::shared_ptr<DTModel> > (dtmodels),
+        f0);
+}
+
+void
+export_gbmodel ()
+{
+    class_<GBModel, bases<Model> > (
+        "GBModel", no_init)
+        .def ("__init__", make_constructor (&gbmodel_from_lists))
+        .def ("get_dtmodel", &GBModel::get_dtmodel)
+        .add_property ("f0", &GBModel::f0)
+        .add_property ("n_dtmodels", &GBModel::n_dtmodels)
+        .def_pickle (GBModel_pickle_suite ())
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<GBModel> > ();
+}
@@ -0,0 +1,48 @@
+// gil.hpp
+// scoped release and acquisition of the Python global interpreter lock
+
+
+#ifndef PYBDT_GIL_HPP
+#define PYBDT_GIL_HPP
+
+#include <Python.h>
+
+#include <boost/utility.hpp>
+
+
+// Release the GIL for the lifetime of this object.  Nothing in its scope
+// may touch Python objects.
+class ReleaseGIL : boost::noncopyable {
+public:
+    ReleaseGIL ()
+        : m_state (PyEval_SaveThread ())
+    { }
+
+    ~ReleaseGIL ()
+    {
+        PyEval_RestoreThread (m_state);
+    }
+
+private:
+    PyThreadState* m_state;
+};
+
+
+// Acquire the GIL for the lifetime of this object, from any native thread.
+class AcquireGIL : boost::noncopyable {
+public:
+    AcquireGIL ()
+        : m_state (PyGILState_Ensure ())
+    { }
+
+    ~AcquireGIL ()
+    {
+        PyGILState_Release (m_state);
+    }
+
+private:
+    PyGILState_STATE m_state;
+};
+
+
+#endif  /* PYBDT_GIL_HPP */
@@ -0,0 +1,83 @@
+// learner.cpp
+// Python bindings for Learner
+
+#include "convert.hpp"
+#include "export.hpp"
+#include "gil.hpp"
+#include "training_handle.hpp"
+
+#include "learner.hpp"
+
+
+using namespace std;
+using namespace boost;
+namespace py = boost::python;
+
+
+// training from Python, with the GIL released
+
+static boost::shared_ptr<Model>
+train_py (const Learner& learner, const DataSet& sig, const DataSet& bg)
+{
+    ReleaseGIL nogil;
+    return learner.train (sig, bg);
+}
+
+static boost::shared_ptr<Model>
+train_given_weights_py (const Learner& learner,
+                        const DataSet& sig, const DataSet& bg,
+                        const vector<double>& sig_weights,
+                        const vector<double>& bg_weights)
+{
+    ReleaseGIL nogil;
+    return learner.train_given_weights (sig, bg, sig_weights, bg_weights);
+}
+
+// returns (models, scores), with the signal scores followed by the
+// background scores in one array
+static py::tuple
+cross_validate_py (const Learner& learner,
+                   const DataSet& sig, const DataSet& bg,
+                   int k, int num_threads)
+{
+    CrossValidation cv;
+    {
+        ReleaseGIL nogil;
+        cv = learner.cross_validate (sig, bg, k, num_threads);
+    }
+    vector<double> scores (cv.sig_scores);
+    scores.insert (scores.end (), cv.bg_scores.begin (), cv.bg_scores.end ());
+    py::list models;
+    for (size_t f (0); f < cv.models.size (); ++f) {
+        models.append (cv.models[f]);
+    }
+    return py::make_tuple (
+        models, py::object (py::handle<> (np::vector_to_array (scores))));
+}
+
+void
+export_learner ()
+{
+    using namespace boost::python;
+
+    class_<Learner, boost::noncopyable> (
+        "Learner",
+        "Train a classification model.", no_init)
+        .def ("train", &train_py)
+        .def ("train_given_weights", &train_given_weights_py)
+        .def ("train_async", &train_async,
+              "Start training on a native thread and return a\n"
+              "TrainingHandle with done(), progress(), cancel() and\n"
+              "result().")
+        .def ("cross_validate", &cross_validate_py,
+              (py::arg ("sig"), py::arg ("bg"), py::arg ("k"),
+               py::arg ("num_threads")=0),
+              "Train k models in parallel, fold f holding out the events\n"
+              "whose index is f modulo k.  Returns (models, scores), where\n"
+              "scores holds the out-of-fold score of every signal event\n"
+              "followed by every background event (NaN for events with\n"
+              "non-finite values).")
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<Learner> > ();
+}
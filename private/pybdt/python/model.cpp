@@ -0,0 +1,59 @@
+// model.cpp
+// Python bindings for Model
+
+#include "convert.hpp"
+#include "export.hpp"
+
+#include "model.hpp"
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+namespace py = boost::python;
+
+
+py::dict
+feature_dict (const Model& model, const vector<double>& values)
+{
+    const vector<string> names (model.feature_names ());
+    py::dict out;
+    for (size_t i_f (0); i_f < names.size (); ++i_f) {
+        out[names[i_f]] = values[i_f];
+    }
+    return out;
+}
+
+static py::list
+model_feature_names (const Model& m)
+{
+    return np::vector_to_list (m.feature_names ());
+}
+
+static double
+model_score_event (Model& m, const py::list& vals, bool use_purity)
+{
+    return m.score (make_scoreable (np::list_to_vector<double> (vals)),
+                    use_purity);
+}
+
+static PyObject*
+model_score_DataSet (Model& m, const DataSet& ds,
+                     bool use_purity, bool quiet)
+{
+    return np::vector_to_array (m.score (ds, use_purity, quiet));
+}
+
+void
+export_model ()
+{
+    class_<Model, boost::noncopyable> (
+        "Model",
+        no_init)
+        .def ("score_DataSet", &model_score_DataSet)
+        .def ("score_event", &model_score_event)
+        .add_property ("feature_names", &model_feature_names)
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<Model> > ();
+}
@@ -0,0 +1,57 @@
+// pruner.cpp
+// Python bindings for the Pruners
+
+#include "export.hpp"
+
+#include "pruner.hpp"
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+
+
+void
+export_pruners ()
+{
+    using namespace boost::python;
+    class_<Pruner, boost::noncopyable> (
+        "Pruner",
+        no_init)
+        .def ("prune", &Pruner::prune)
+        ;
+
+    class_<SameLeafPruner, bases<Pruner> > (
+        "SameLeafPruner",
+        init<> ())
+        ;
+
+    class_<CostComplexityPruner, bases<Pruner> > (
+        "CostComplexityPruner",
+        init<double> ())
+        .add_property (
+            "strength", 
+            (double (CostComplexityPruner::*)()const)
+            &CostComplexityPruner::strength,
+            (void (CostComplexityPruner::*)(double))
+            &CostComplexityPruner::strength)
+        .def ("gain", &CostComplexityPruner::gain).staticmethod ("gain")
+        .def ("rho", &CostComplexityPruner::rho).staticmethod ("rho")
+        ;
+
+    class_<ErrorPruner, bases<Pruner> > (
+        "ErrorPruner",
+        init<double> ())
+        .add_property (
+            "strength", 
+            (double (ErrorPruner::*)()const) &ErrorPruner::strength,
+            (void (ErrorPruner::*)(double)) &ErrorPruner::strength)
+        .def ("subtree_error", &ErrorPruner::subtree_error)
+        .def ("node_error", &ErrorPruner::node_error)
+        ;
+
+    register_ptr_to_python <boost::shared_ptr<Pruner> > ();
+    register_ptr_to_python <boost::shared_ptr<SameLeafPruner> > ();
+    register_ptr_to_python <boost::shared_ptr<CostComplexityPruner> > ();
+    register_ptr_to_python <boost::shared_ptr<ErrorPruner> > ();
+}
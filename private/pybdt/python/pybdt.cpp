@@ -23,16 +23,7 @@
 #define PY_ARRAY_UNIQUE_SYMBOL pybdt_ARRAY_API
 #include <numpy/ndarrayobject.h>
 
-#include "np.hpp"
-#include "dataset.hpp"
-#include "model.hpp"
-#include "learner.hpp"
-#include "dtmodel.hpp"
-#include "dtlearner.hpp"
-#include "bdtmodel.hpp"
-#include "bdtlearner.hpp"
-#include "vinemodel.hpp"
-#include "vinelearner.hpp"
+#include "export.hpp"
 
 
 using namespace std;
@@ -54,10 +45,14 @@ BOOST_PYTHON_MODULE (_pybdt)
     export_model ();
     export_dtmodel ();
     export_bdtmodel ();
+    export_gbmodel ();
     export_vinemodel ();
     export_learner ();
     export_dtlearner ();
     export_bdtlearner ();
     export_vinelearner ();
     export_pruners ();
+    export_training_handle ();
+    export_training_log ();
+    export_training_profile ();
 }
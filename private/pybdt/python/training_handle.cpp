@@ -0,0 +1,134 @@
+// training_handle.cpp
+
+#include <Python.h>
+
+#include "training_handle.hpp"
+
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
+#include "gil.hpp"
+
+
+using namespace std;
+using namespace boost;
+namespace py = boost::python;
+
+
+TrainingHandle::TrainingHandle (py::object learner,
+                                py::object sig, py::object bg)
+:   m_learner_py (learner), m_sig_py (sig), m_bg_py (bg),
+    m_learner (py::extract<const Learner&> (learner)),
+    m_sig (py::extract<const DataSet&> (sig)),
+    m_bg (py::extract<const DataSet&> (bg)),
+    m_done (false), m_cancelled (false)
+{
+    m_thread = boost::thread (boost::bind (&TrainingHandle::run, this));
+}
+
+TrainingHandle::~TrainingHandle ()
+{
+    m_status.cancel ();
+    join ();
+}
+
+bool
+TrainingHandle::done () const
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    return m_done;
+}
+
+double
+TrainingHandle::progress () const
+{
+    return m_status.progress ();
+}
+
+void
+TrainingHandle::cancel ()
+{
+    m_status.cancel ();
+}
+
+boost::shared_ptr<Model>
+TrainingHandle::result ()
+{
+    join ();
+    boost::mutex::scoped_lock lock (m_mutex);
+    if (m_cancelled) {
+        throw TrainingCancelled ();
+    }
+    if (not m_error.empty ()) {
+        throw runtime_error (m_error);
+    }
+    return m_result;
+}
+
+void
+TrainingHandle::run ()
+{
+    // runs on m_thread, without the GIL
+    boost::shared_ptr<Model> model;
+    bool cancelled (false);
+    string error;
+    try {
+        model = m_learner.train (m_sig, m_bg, &m_status);
+    }
+    catch (const TrainingCancelled&) {
+        cancelled = true;
+    }
+    catch (const std::exception& e) {
+        error = e.what ();
+        if (error.empty ()) {
+            error = "training failed";
+        }
+    }
+    catch (...) {
+        error = "training failed with an unknown error";
+    }
+    boost::mutex::scoped_lock lock (m_mutex);
+    m_result = model;
+    m_cancelled = cancelled;
+    m_error = error;
+    m_done = true;
+}
+
+void
+TrainingHandle::join ()
+{
+    if (m_thread.joinable ()) {
+        ReleaseGIL nogil;
+        m_thread.join ();
+    }
+}
+
+
+boost::shared_ptr<TrainingHandle>
+train_async (py::object learner, py::object sig, py::object bg)
+{
+    return boost::make_shared<TrainingHandle> (learner, sig, bg);
+}
+
+void
+export_training_handle ()
+{
+    using namespace boost::python;
+
+    class_<TrainingHandle, boost::shared_ptr<TrainingHandle>,
+        boost::noncopyable> (
+        "TrainingHandle",
+        "A training running on a native thread; see Learner.train_async.",
+        no_init)
+        .def ("done", &TrainingHandle::done,
+              "Return True once the training has finished.")
+        .def ("progress", &TrainingHandle::progress,
+              "Return the completed fraction of the training.")
+        .def ("cancel", &TrainingHandle::cancel,
+              "Ask the training to stop as soon as possible.")
+        .def ("result", &TrainingHandle::result,
+              "Wait for the training and return the trained Model.")
+        ;
+}
@@ -0,0 +1,79 @@
+// training_handle.hpp
+// a training running on its own native thread
+
+
+#ifndef PYBDT_TRAINING_HANDLE_HPP
+#define PYBDT_TRAINING_HANDLE_HPP
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/utility.hpp>
+
+#include "boost_python.hpp"
+
+#include "dataset.hpp"
+#include "learner.hpp"
+#include "model.hpp"
+#include "training_status.hpp"
+
+class TrainingHandle : boost::noncopyable {
+public:
+
+    // structors
+
+    // learner, sig and bg must wrap a Learner and two DataSets; the
+    // references are held until the handle is destroyed, so that the
+    // training thread never needs the GIL
+    TrainingHandle (boost::python::object learner,
+                    boost::python::object sig,
+                    boost::python::object bg);
+
+    // cancels and waits for the training if it is still running
+    ~TrainingHandle ();
+
+    // inspectors
+
+    bool done () const;
+    double progress () const;
+
+    // mutators
+
+    void cancel ();
+
+    // wait for the training to finish and return the trained Model;
+    // throws if the training failed or was cancelled
+    boost::shared_ptr<Model> result ();
+
+private:
+
+    void run ();
+    void join ();
+
+    boost::python::object m_learner_py;
+    boost::python::object m_sig_py;
+    boost::python::object m_bg_py;
+    const Learner& m_learner;
+    const DataSet& m_sig;
+    const DataSet& m_bg;
+
+    TrainingStatus m_status;
+    boost::thread m_thread;
+
+    mutable boost::mutex m_mutex;
+    bool m_done;
+    bool m_cancelled;
+    std::string m_error;
+    boost::shared_ptr<Model> m_result;
+
+};
+
+
+// start training learner on sig and bg; exposed as Learner.train_async
+boost::shared_ptr<TrainingHandle> train_async (
+    boost::python::object learner,
+    boost::python::object sig,
+    boost::python::object bg);
+
+#endif  /* PYBDT_TRAINING_HANDLE_HPP */
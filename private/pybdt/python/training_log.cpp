@@ -0,0 +1,134 @@
+// training_log.cpp
+// Python bindings for TrainingLog
+
+#include "export.hpp"
+#include "gil.hpp"
+
+#include "training_log.hpp"
+
+#include <stdexcept>
+
+
+using namespace std;
+using namespace boost;
+namespace py = boost::python;
+
+
+static py::dict
+record_to_dict (const TreeRecord& record)
+{
+    py::dict out;
+    out["run"] = record.run;
+    out["tree"] = record.tree;
+    out["num_trees"] = record.num_trees;
+    out["error"] = record.error;
+    out["alpha"] = record.alpha;
+    out["n_leaves"] = record.n_leaves;
+    out["max_depth"] = record.max_depth;
+    out["seconds"] = record.seconds;
+    return out;
+}
+
+namespace {
+
+// Calls a Python callable with the GIL held, from whichever thread the
+// training runs in.  The reference is managed by hand, since copies may be
+// released on a thread that does not hold the GIL.
+class PyLogCallback {
+public:
+    explicit PyLogCallback (py::object func)
+        : m_func (func.ptr ())
+    {
+        Py_INCREF (m_func);
+    }
+
+    PyLogCallback (const PyLogCallback& other)
+        : m_func (other.m_func)
+    {
+        AcquireGIL gil;
+        Py_INCREF (m_func);
+    }
+
+    ~PyLogCallback ()
+    {
+        AcquireGIL gil;
+        Py_DECREF (m_func);
+    }
+
+    void operator() (const TreeRecord& record) const
+    {
+        AcquireGIL gil;
+        try {
+            py::call<void> (m_func, record_to_dict (record));
+        }
+        catch (const py::error_already_set&) {
+            PyErr_Print ();
+            throw runtime_error ("exception in training log callback");
+        }
+    }
+
+private:
+    PyLogCallback& operator= (const PyLogCallback&);
+
+    PyObject* m_func;
+};
+
+}
+
+static string
+level_py (const TrainingLog& log)
+{
+    return TrainingLog::level_to_string (log.level ());
+}
+
+static void
+set_level_py (TrainingLog& log, const string& name)
+{
+    log.level (TrainingLog::level_from_string (name));
+}
+
+static py::list
+records_py (const TrainingLog& log)
+{
+    const vector<TreeRecord> records (log.records ());
+    py::list out;
+    for (size_t i (0); i < records.size (); ++i) {
+        out.append (record_to_dict (records[i]));
+    }
+    return out;
+}
+
+static void
+set_callback_py (TrainingLog& log, py::object func)
+{
+    if (func.is_none ()) {
+        log.callback (TrainingLog::Callback ());
+    }
+    else {
+        log.callback (PyLogCallback (func));
+    }
+}
+
+void
+export_training_log ()
+{
+    using namespace boost::python;
+
+    class_<TrainingLog, boost::shared_ptr<TrainingLog>,
+        boost::noncopyable> (
+            "TrainingLog",
+            "Messages and per-tree records from training.\n\n"
+            "level is one of 'none', 'info' (the default), 'tree' (a\n"
+            "line per tree) and 'debug'.  records lists a dict per\n"
+            "tree of the latest training, whatever the level; its 'run'\n"
+            "tells apart the grid members, folds or vine windows of\n"
+            "trainings run together (empty for a single training).",
+            init<> ())
+        .add_property ("level", &level_py, &set_level_py)
+        .add_property ("records", &records_py)
+        .def ("clear", &TrainingLog::clear)
+        .def ("set_callback", &set_callback_py,
+              "Call func (record) after each tree, from the training\n"
+              "thread; None removes the callback.")
+        ;
+}
@@ -0,0 +1,66 @@
+// training_profile.cpp
+// Python bindings for TrainingProfile
+
+#include "export.hpp"
+
+#include "training_profile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+
+using namespace std;
+using namespace boost;
+namespace py = boost::python;
+
+
+static py::dict
+phases_py (const TrainingProfile& profile)
+{
+    typedef map<string, TrainingProfile::Phase> phase_map;
+    const phase_map phases (profile.phases ());
+    py::dict out;
+    for (phase_map::const_iterator i_phase = phases.begin ();
+         i_phase != phases.end (); ++i_phase) {
+        py::dict phase;
+        phase["seconds"] = i_phase->second.seconds;
+        phase["calls"] = i_phase->second.calls;
+        phase["events"] = i_phase->second.events;
+        phase["est_bytes"] = i_phase->second.est_bytes;
+        out[i_phase->first] = phase;
+    }
+    return out;
+}
+
+static void
+write_chrome_trace_py (const TrainingProfile& profile, const string& filename)
+{
+    ofstream os (filename.c_str ());
+    os << profile.chrome_trace ();
+    if (not os) {
+        throw runtime_error ("could not write \"" + filename + "\"");
+    }
+}
+
+void
+export_training_profile ()
+{
+    using namespace boost::python;
+
+    class_<TrainingProfile, boost::shared_ptr<TrainingProfile>,
+        boost::noncopyable> (
+            "TrainingProfile",
+            "Per-phase wall time, calls, events touched and estimated\n"
+            "bytes allocated, accumulated over the trainings run while\n"
+            "profiling was enabled.  The byte figures are estimates\n"
+            "from container sizes, not measurements.",
+            init<> ())
+        .def ("as_dict", &phases_py,
+              "Map each phase to a dict of seconds, calls, events and\n"
+              "est_bytes.")
+        .def ("chrome_trace", &TrainingProfile::chrome_trace,
+              "The recorded spans as Chrome trace event JSON.")
+        .def ("write_chrome_trace", &write_chrome_trace_py)
+        .def ("clear", &TrainingProfile::clear)
+        ;
+}
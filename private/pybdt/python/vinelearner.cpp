@@ -0,0 +1,52 @@
+// vinelearner.cpp
+// Python bindings for VineLearner
+
+#include "export.hpp"
+
+#include "vinelearner.hpp"
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+
+
+void export_vinelearner ()
+{
+    using namespace boost::python;
+
+    class_<VineLearner, bases<Learner> > (
+        "VineLearner",
+        init<string,double,double,double,double,boost::shared_ptr<Learner> > ())
+        .add_property (
+            "vine_feature",
+            (string (VineLearner::*)()const) &VineLearner::vine_feature,
+            (void (VineLearner::*)(const string&)) &VineLearner::vine_feature)
+        .add_property (
+            "vine_feature_min",
+            (double (VineLearner::*)()const) &VineLearner::vine_feature_min,
+            (void (VineLearner::*)(double)) &VineLearner::vine_feature_min)
+        .add_property (
+            "vine_feature_max",
+            (double (VineLearner::*)()const) &VineLearner::vine_feature_max,
+            (void (VineLearner::*)(double)) &VineLearner::vine_feature_max)
+        .add_property (
+            "vine_feature_width",
+            (double (VineLearner::*)()const) &VineLearner::vine_feature_width,
+            (void (VineLearner::*)(double)) &VineLearner::vine_feature_width)
+        .add_property (
+            "vine_feature_step",
+            (double (VineLearner::*)()const) &VineLearner::vine_feature_step,
+            (void (VineLearner::*)(double)) &VineLearner::vine_feature_step)
+        .add_property (
+            "num_threads",
+            (int (VineLearner::*)()const) &VineLearner::num_threads,
+            (void (VineLearner::*)(int)) &VineLearner::num_threads)
+        .add_property (
+            "window_events",
+            (int (VineLearner::*)()const) &VineLearner::window_events,
+            (void (VineLearner::*)(int)) &VineLearner::window_events)
+        .add_property (
+            "learner", &VineLearner::learner)
+        ;
+}
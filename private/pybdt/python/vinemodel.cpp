@@ -0,0 +1,53 @@
+// vinemodel.cpp
+// Python bindings for VineModel
+
+#include "convert.hpp"
+#include "export.hpp"
+
+#include "vinemodel.hpp"
+
+#include <boost/make_shared.hpp>
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::python;
+namespace py = boost::python;
+
+
+struct VineModel_pickle_suite : py::pickle_suite {
+    static
+    py::tuple getinitargs (const VineModel& m)
+    {
+        return py::make_tuple (
+            np::vector_to_list (m.feature_names ()),
+            m.vine_feature (),
+            np::vector_to_list (m.bin_mins ()),
+            np::vector_to_list (m.bin_maxs ()),
+            np::vector_to_list (m.models ()));
+    }
+};
+
+static boost::shared_ptr<VineModel>
+vinemodel_from_lists (const py::list& feature_names,
+                      const string& vine_feature,
+                      const py::list& bin_mins,
+                      const py::list& bin_maxs,
+                      const py::list& models)
+{
+    return boost::make_shared<VineModel> (
+        np::list_to_vector<string> (feature_names),
+        vine_feature,
+        np::list_to_vector<double> (bin_mins),
+        np::list_to_vector<double> (bin_maxs),
+        np::list_to_vector<boost::shared_ptr<Model> > (models));
+}
+
+void export_vinemodel ()
+{
+    class_<VineModel, bases<Model> > (
+        "VineModel", no_init)
+        .def ("__init__", make_constructor (&vinemodel_from_lists))
+        .def_pickle (VineModel_pickle_suite ())
+        ;
+}
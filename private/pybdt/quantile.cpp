@@ -0,0 +1,141 @@
+// quantile.cpp
+
+#include "quantile.hpp"
+
+#include <algorithm>
+
+
+using namespace std;
+
+
+namespace {
+
+double
+median_of_three (double a, double b, double c)
+{
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    else {
+        return a < c ? a : (b < c ? c : b);
+    }
+}
+
+}
+
+double
+weighted_quantile (vecpdd& rw_vpair, double quant_val,
+                   bool weighted, double weight_sum)
+{
+    return weighted_quantile (rw_vpair.begin (), rw_vpair.end (),
+                              quant_val, weighted, weight_sum);
+}
+
+double
+weighted_quantile (vecpdd_iter first, vecpdd_iter last, double quant_val,
+                   bool weighted, double weight_sum)
+{
+    double target = quant_val * (weighted ? weight_sum : last - first);
+    if (first == last or not (target > 0)) {
+        return 0;
+    }
+    for (;;) {
+        const double pivot = median_of_three (
+            first->first, (first + (last - first) / 2)->first,
+            (last - 1)->first);
+        // three-way partition into [first, lt) < pivot,
+        // [lt, gt) == pivot and [gt, last) > pivot
+        vecpdd_iter lt (first);
+        vecpdd_iter i (first);
+        vecpdd_iter gt (last);
+        double w_lt (0);
+        double w_eq (0);
+        while (i != gt) {
+            const double w = weighted ? i->second : 1;
+            if (i->first < pivot) {
+                w_lt += w;
+                iter_swap (i++, lt++);
+            }
+            else if (pivot < i->first) {
+                iter_swap (i, --gt);
+            }
+            else {
+                w_eq += w;
+                ++i;
+            }
+        }
+        if (lt != first and w_lt >= target) {
+            last = lt;
+        }
+        else if (w_lt + w_eq >= target or gt == last) {
+            return pivot;
+        }
+        else {
+            target -= w_lt + w_eq;
+            first = gt;
+        }
+    }
+}
+
+
+QuantileSketch::QuantileSketch (int capacity)
+    : m_capacity (max (capacity, 1)), m_weight_sum (0)
+{
+    m_buffer.reserve (2 * m_capacity);
+}
+
+void
+QuantileSketch::add (double value, double weight)
+{
+    m_buffer.push_back (make_pair (value, weight));
+    m_weight_sum += weight;
+    if (m_buffer.size () >= 2u * m_capacity) {
+        compress ();
+    }
+}
+
+double
+QuantileSketch::quantile (double quant_val, double weight_sum) const
+{
+    vecpdd buffer (m_buffer);
+    return weighted_quantile (buffer, quant_val, true, weight_sum);
+}
+
+double
+QuantileSketch::weight_sum () const
+{
+    return m_weight_sum;
+}
+
+void
+QuantileSketch::compress ()
+{
+    // merge runs of adjacent values into entries of about
+    // m_weight_sum / m_capacity each, represented by the value at which
+    // the run's weight crosses its midpoint
+    sort (m_buffer.begin (), m_buffer.end ());
+    const double step (m_weight_sum / m_capacity);
+    vecpdd merged;
+    merged.reserve (2 * m_capacity);
+    double run_weight (0);
+    double run_value (0);
+    bool have_value (false);
+    for (vecpdd_iter i = m_buffer.begin (); i != m_buffer.end (); ++i) {
+        if (not have_value and run_weight + i->second >= step / 2) {
+            run_value = i->first;
+            have_value = true;
+        }
+        run_weight += i->second;
+        if (run_weight >= step) {
+            merged.push_back (make_pair (run_value, run_weight));
+            run_weight = 0;
+            have_value = false;
+        }
+    }
+    if (run_weight > 0) {
+        merged.push_back (
+            make_pair (have_value ? run_value : m_buffer.back ().first,
+                       run_weight));
+    }
+    m_buffer.swap (merged);
+}
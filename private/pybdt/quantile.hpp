@@ -0,0 +1,50 @@
+// quantile.hpp
+// weighted quantiles of (value, weight) pairs
+
+
+#ifndef PYBDT_QUANTILE_HPP
+#define PYBDT_QUANTILE_HPP
+
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<double,double> > vecpdd;
+typedef vecpdd::iterator vecpdd_iter;
+
+// Value at which the cumulative weight of the values, taken in ascending
+// order, first reaches quant_val * weight_sum; the largest value if it
+// never does, and 0 if the target is not positive.  Weights of 1 are used
+// if weighted is false.  Runs in expected linear time by weighted
+// quickselect; the pairs are reordered in place.
+double weighted_quantile (vecpdd& rw_vpair, double quant_val,
+                          bool weighted, double weight_sum);
+
+// the same for the pairs in [first, last)
+double weighted_quantile (vecpdd_iter first, vecpdd_iter last,
+                          double quant_val,
+                          bool weighted, double weight_sum);
+
+// Bounded-memory approximation of weighted_quantile for large inputs.
+// Pairs are buffered until the buffer holds 2 * capacity entries, which
+// are then merged into capacity entries of roughly equal weight, so the
+// rank error stays within a few multiples of total weight / capacity.
+class QuantileSketch {
+public:
+    explicit QuantileSketch (int capacity=1024);
+
+    void add (double value, double weight=1);
+
+    double quantile (double quant_val, double weight_sum) const;
+    double weight_sum () const;
+
+private:
+
+    void compress ();
+
+    int m_capacity;
+    double m_weight_sum;
+    vecpdd m_buffer;
+
+};
+
+#endif  /* PYBDT_QUANTILE_HPP */
@@ -3,12 +3,245 @@
 
 #include "random_sampler.hpp"
 
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+
+using namespace std;
+using boost::uint32_t;
+using boost::uint64_t;
+
+
+namespace {
+
+const char* const generator_name ("philox4x32-10");
+
+// one Philox4x32-10 block: ten rounds of multiply-xor over the counter,
+// bumping the key between rounds
+void
+philox (const uint32_t* counter, const uint32_t* key, uint32_t* out)
+{
+    const uint32_t M0 (0xD2511F53), M1 (0xCD9E8D57);
+    const uint32_t W0 (0x9E3779B9), W1 (0xBB67AE85);
+    uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+    uint32_t k[2] = {key[0], key[1]};
+    for (int round (0); round < 10; ++round) {
+        const uint64_t p0 (uint64_t (M0) * c[0]);
+        const uint64_t p1 (uint64_t (M1) * c[2]);
+        const uint32_t c0 (uint32_t (p1 >> 32) ^ c[1] ^ k[0]);
+        const uint32_t c2 (uint32_t (p0 >> 32) ^ c[3] ^ k[1]);
+        c[0] = c0;
+        c[1] = uint32_t (p1);
+        c[2] = c2;
+        c[3] = uint32_t (p0);
+        k[0] += W0;
+        k[1] += W1;
+    }
+    copy (c, c + 4, out);
+}
+
+}
 
 
 RandomSampler::RandomSampler (int seed)
+    : m_n_used (4)
+{
+    m_key[0] = uint32_t (seed);
+    m_key[1] = 0;
+    fill (m_counter, m_counter + 4, 0);
+    fill (m_block, m_block + 4, 0);
+}
+
+RandomSampler
+RandomSampler::stream (unsigned long id) const
+{
+    // the new key is a block keyed on this key, at a counter the main
+    // sequence never reaches
+    const uint64_t id64 (id);
+    const uint32_t counter[4] = {
+        uint32_t (id64), uint32_t (id64 >> 32), 0, 0x80000000};
+    uint32_t block[4];
+    philox (counter, m_key, block);
+    RandomSampler out;
+    out.m_key[0] = block[0];
+    out.m_key[1] = block[1];
+    return out;
+}
+
+void
+RandomSampler::refill ()
+{
+    philox (m_counter, m_key, m_block);
+    for (int i (0); i < 4 and ++m_counter[i] == 0; ++i) {
+    }
+    m_n_used = 0;
+}
+
+uint32_t
+RandomSampler::next ()
+{
+    if (m_n_used == 4) {
+        refill ();
+    }
+    return m_block[m_n_used++];
+}
+
+unsigned
+RandomSampler::uniform_int (unsigned n)
+{
+    assert (n > 0);
+    // multiply-shift with rejection of the biased low range (Lemire)
+    const uint32_t n32 (n);
+    uint64_t m (uint64_t (next ()) * n32);
+    uint32_t low (static_cast<uint32_t> (m));
+    if (low < n32) {
+        const uint32_t threshold ((0u - n32) % n32);
+        while (low < threshold) {
+            m = uint64_t (next ()) * n32;
+            low = uint32_t (m);
+        }
+    }
+    return unsigned (m >> 32);
+}
+
+double
+RandomSampler::uniform ()
+{
+    const uint64_t bits ((uint64_t (next ()) << 32) | next ());
+    return (bits >> 11) * (1. / 9007199254740992.);
+}
+
+void
+RandomSampler::sample_indices (unsigned n, unsigned len, bool replace,
+                               vector<int>& out)
+{
+    out.resize (n);
+    if (replace) {
+        for (unsigned i (0); i < n; ++i) {
+            out[i] = uniform_int (len);
+        }
+        return;
+    }
+    if (n > len) {
+        throw runtime_error (
+            "cannot sample more items than available without replacement");
+    }
+    for (unsigned i (m_perm.size ()); i < len; ++i) {
+        m_perm.push_back (i);
+    }
+    m_swaps.resize (n);
+    for (unsigned i (0); i < n; ++i) {
+        const unsigned j (i + uniform_int (len - i));
+        swap (m_perm[i], m_perm[j]);
+        m_swaps[i] = j;
+        out[i] = m_perm[i];
+    }
+    for (unsigned i (n); i-- > 0;) {
+        swap (m_perm[i], m_perm[m_swaps[i]]);
+    }
+}
+
+void
+RandomSampler::sample_weighted (unsigned n, const vector<double>& weights,
+                                vector<int>& out)
+{
+    // Vose's alias method: bin i is kept with probability m_alias_prob[i]
+    // and otherwise replaced by m_alias[i]
+    const unsigned len (weights.size ());
+    double total (0);
+    for (unsigned i (0); i < len; ++i) {
+        if (not (weights[i] >= 0)) {
+            throw runtime_error ("cannot sample with negative weights");
+        }
+        total += weights[i];
+    }
+    if (not (total > 0)) {
+        throw runtime_error ("cannot sample with zero total weight");
+    }
+    m_alias_prob.resize (len);
+    m_alias.resize (len);
+    m_small.clear ();
+    m_large.clear ();
+    for (unsigned i (0); i < len; ++i) {
+        m_alias_prob[i] = weights[i] * len / total;
+        m_alias[i] = i;
+        (m_alias_prob[i] < 1 ? m_small : m_large).push_back (i);
+    }
+    while (m_small.size () and m_large.size ()) {
+        const unsigned small (m_small.back ());
+        const unsigned large (m_large.back ());
+        m_small.pop_back ();
+        m_alias[small] = large;
+        m_alias_prob[large] -= 1 - m_alias_prob[small];
+        if (m_alias_prob[large] < 1) {
+            m_large.pop_back ();
+            m_small.push_back (large);
+        }
+    }
+    // whatever is left is full up to rounding
+    for (size_t j (0); j < m_small.size (); ++j) {
+        m_alias_prob[m_small[j]] = 1;
+    }
+    for (size_t j (0); j < m_large.size (); ++j) {
+        m_alias_prob[m_large[j]] = 1;
+    }
+
+    out.resize (n);
+    for (unsigned i_pick (0); i_pick < n; ++i_pick) {
+        const unsigned i (uniform_int (len));
+        out[i_pick] = uniform () < m_alias_prob[i] ? i : m_alias[i];
+    }
+}
+
+void
+RandomSampler::save_state (ostream& os) const
+{
+    // generator name first, so that a state is never loaded into a
+    // generator of a different type
+    const string name (generator_name);
+    const size_t name_size (name.size ());
+    uint32_t state[11];
+    copy (m_key, m_key + 2, state);
+    copy (m_counter, m_counter + 4, state + 2);
+    copy (m_block, m_block + 4, state + 6);
+    state[10] = m_n_used;
+    const size_t state_size (sizeof (state));
+    os.write (reinterpret_cast<const char*> (&name_size), sizeof (name_size));
+    os.write (name.data (), name_size);
+    os.write (reinterpret_cast<const char*> (&state_size), sizeof (state_size));
+    os.write (reinterpret_cast<const char*> (state), state_size);
+}
+
+void
+RandomSampler::load_state (istream& is)
 {
-    gsl_rng_env_setup ();
-    const gsl_rng_type* T (gsl_rng_default);
-    m_rng = gsl_rng_alloc (T);
-    gsl_rng_set (m_rng, seed);
+    size_t name_size (0);
+    is.read (reinterpret_cast<char*> (&name_size), sizeof (name_size));
+    if (not is or name_size > 1024) {
+        throw runtime_error ("could not read random number generator state");
+    }
+    string name (name_size, ' ');
+    is.read (&name[0], name_size);
+    size_t state_size (0);
+    is.read (reinterpret_cast<char*> (&state_size), sizeof (state_size));
+    if (not is) {
+        throw runtime_error ("could not read random number generator state");
+    }
+    uint32_t state[11];
+    if (name != generator_name or state_size != sizeof (state)) {
+        throw runtime_error (
+            "random number generator state is for \"" + name
+            + "\", not \"" + generator_name + "\"");
+    }
+    is.read (reinterpret_cast<char*> (state), state_size);
+    if (not is or state[10] > 4) {
+        throw runtime_error ("could not read random number generator state");
+    }
+    copy (state, state + 2, m_key);
+    copy (state + 2, state + 6, m_counter);
+    copy (state + 6, state + 10, m_block);
+    m_n_used = state[10];
 }
@@ -5,18 +5,47 @@
 #ifndef PYBDT_RANDOM_SAMPLER_HPP
 #define PYBDT_RANDOM_SAMPLER_HPP
 
-#include <set>
+#include <cassert>
+#include <iosfwd>
 #include <vector>
 
-#include <gsl/gsl_randist.h>
-#include <gsl/gsl_rng.h>
+#include <boost/cstdint.hpp>
 
 #include "np.hpp"
 
+// Random numbers from the counter-based Philox4x32-10 generator.
+//
+// stream (id) splits off an independent generator keyed on this one's key
+// and id alone, so e.g. each tree can draw from its own reproducible
+// stream no matter what other streams have drawn or which thread runs
+// first.
 class RandomSampler {
 public:
     RandomSampler (int seed = 0);
 
+    RandomSampler stream (unsigned long id) const;
+
+    // serialization of the generator state, e.g. for checkpointing
+    void save_state (std::ostream& os) const;
+    void load_state (std::istream& is);
+
+    // uniform in [0, 2^32), [0, n) and [0, 1)
+    boost::uint32_t next ();
+    unsigned uniform_int (unsigned n);
+    double uniform ();
+
+    // n indices in [0, len) into out; without replacement (n <= len) they
+    // come from a partial Fisher-Yates shuffle of a reused buffer, which
+    // is put back in order afterwards
+    void sample_indices (unsigned n, unsigned len, bool replace,
+                         std::vector<int>& out);
+
+    // n indices in [0, weights.size ()) into out, drawn with replacement
+    // with probability proportional to weights; the alias table is built
+    // in O(len) and each draw is O(1)
+    void sample_weighted (unsigned n, const std::vector<double>& weights,
+                          std::vector<int>& out);
+
     template <typename T>
     std::vector<T> sample (
         const unsigned n, const std::vector<T>& vec, const bool replace=false)
@@ -34,27 +63,32 @@ public:
     {
         using namespace std;
         assert (i2 > i1);
-        const T2 len (i2 - i1);
-        vector<T> out;
-        out.reserve (n);
-        set<unsigned> already_picked;
+        sample_indices (n, i2 - i1, replace, m_indices);
+        vector<T> out (n);
         for (unsigned i_pick (0); i_pick < n; ++i_pick) {
-            unsigned pick = gsl_rng_uniform_int (m_rng, len) + i1;
-            if (not replace) {
-                // if not replacing, keep picking till a new one is found
-                while (already_picked.find (pick) != already_picked.end ()) {
-                    pick = gsl_rng_uniform_int (m_rng, len) + i1;
-                }
-                already_picked.insert (pick);
-            }
-            out.push_back (pick);
+            out[i_pick] = m_indices[i_pick] + i1;
         }
         return out;
     }
 
 private:
 
-    gsl_rng* m_rng;
+    // the next block of four outputs
+    void refill ();
+
+    boost::uint32_t m_key[2];
+    boost::uint32_t m_counter[4];
+    boost::uint32_t m_block[4];
+    int m_n_used;
+
+    // scratch space for sampling; m_perm is the identity between calls
+    std::vector<unsigned> m_perm;
+    std::vector<unsigned> m_swaps;
+    std::vector<int> m_indices;
+    std::vector<double> m_alias_prob;
+    std::vector<unsigned> m_alias;
+    std::vector<unsigned> m_small;
+    std::vector<unsigned> m_large;
 
 };
 
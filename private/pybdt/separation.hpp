@@ -0,0 +1,423 @@
+// separation.hpp
+// separation criteria and the split scan specialized on each of them
+
+
+#ifndef PYBDT_SEPARATION_HPP
+#define PYBDT_SEPARATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+// The AVX2 scan is compiled for that target alone and picked at run time
+// where the CPU supports it, so the default build (no -mavx2) still gets
+// it and runs anywhere.  Only GCC and Clang on x86 have the means.
+#if (defined (__GNUC__) || defined (__clang__)) \
+    && (defined (__x86_64__) || defined (__i386__))
+#define PYBDT_SCAN_AVX2
+#define PYBDT_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#include <immintrin.h>
+#endif
+
+
+struct SepFunc;
+
+// Input and result of the search for the best cut on one feature.  The
+// cut candidates are the right edges of all bins but the last; the scan
+// keeps its scratch array here, so reuse one SplitScan per node.
+struct SplitScan {
+    // per-bin sums, n_bins each; bin i is at [stride * i], so the four
+    // may be separate arrays or interleaved in one
+    const double* w_sig;
+    const double* w_bg;
+    const double* n_sig;
+    const double* n_bg;
+    int stride;
+    int n_bins;
+    // totals over all bins, and the separation index of the parent
+    double w_sig_total;
+    double w_bg_total;
+    double n_sig_total;
+    double n_bg_total;
+    double sep_here;
+    int min_split;
+    // updated only where a cut beats best_gain: the cut is at the right
+    // edge of bin best_bin
+    double best_gain;
+    int best_bin;
+
+    // gain of each cut; -inf where min_split is not met on both sides
+    std::vector<double> gain;
+};
+
+typedef void (*SplitScanFunc) (const SepFunc& sep, SplitScan& scan);
+
+
+// Gains of cuts [begin, n_cuts), one at a time.  left and right hold the
+// running (w_sig, w_bg, n_sig, n_bg) sums on either side of cut begin - 1.
+template <typename Sep>
+void
+scan_gains (const Sep& sep, SplitScan& s, int begin, int n_cuts,
+            const double* left, const double* right)
+{
+    double w_sig_left (left[0]), w_sig_right (right[0]);
+    double w_bg_left (left[1]), w_bg_right (right[1]);
+    double n_sig_left (left[2]), n_sig_right (right[2]);
+    double n_bg_left (left[3]), n_bg_right (right[3]);
+    const double w_sep_here ((s.w_sig_total + s.w_bg_total) * s.sep_here);
+    for (int i (begin); i < n_cuts; ++i) {
+        const int j (s.stride * i);
+        w_sig_left += s.w_sig[j];
+        w_bg_left += s.w_bg[j];
+        n_sig_left += s.n_sig[j];
+        n_bg_left += s.n_bg[j];
+        w_sig_right -= s.w_sig[j];
+        w_bg_right -= s.w_bg[j];
+        n_sig_right -= s.n_sig[j];
+        n_bg_right -= s.n_bg[j];
+        const double w_left (w_sig_left + w_bg_left);
+        const double w_right (w_sig_right + w_bg_right);
+        if (n_sig_left + n_bg_left >= s.min_split
+            and n_sig_right + n_bg_right >= s.min_split) {
+            s.gain[i] = w_sep_here
+                - (w_left * sep.value (w_sig_left / w_left))
+                - (w_right * sep.value (w_sig_right / w_right));
+        }
+        else {
+            s.gain[i] = -std::numeric_limits<double>::infinity ();
+        }
+    }
+}
+
+#ifdef PYBDT_SCAN_AVX2
+
+// whether this CPU runs AVX2 code; checked once
+inline bool
+cpu_has_avx2 ()
+{
+    static const bool has_avx2 (
+        (__builtin_cpu_init (), __builtin_cpu_supports ("avx2")));
+    return has_avx2;
+}
+
+// transpose the 4x4 block whose rows are r[0] ... r[3]
+PYBDT_TARGET_AVX2 inline void
+transpose4 (__m256d* r)
+{
+    const __m256d t0 (_mm256_unpacklo_pd (r[0], r[1]));
+    const __m256d t1 (_mm256_unpackhi_pd (r[0], r[1]));
+    const __m256d t2 (_mm256_unpacklo_pd (r[2], r[3]));
+    const __m256d t3 (_mm256_unpackhi_pd (r[2], r[3]));
+    r[0] = _mm256_permute2f128_pd (t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd (t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd (t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd (t1, t3, 0x31);
+}
+
+// Gains of all cuts, four at a time.  One register carries the running
+// (w_sig, w_bg, n_sig, n_bg) sums, so the prefix sums of all four
+// quantities advance together; each block of four cuts is transposed so
+// that the gains of the four cuts come out of one vector pass, with
+// min_split applied as a mask.
+template <typename Sep>
+PYBDT_TARGET_AVX2 void
+scan_gains_avx2 (const Sep& sep, SplitScan& s, int n_cuts)
+{
+    const __m256d min_split (_mm256_set1_pd (s.min_split));
+    const __m256d w_sep_here (
+        _mm256_set1_pd ((s.w_sig_total + s.w_bg_total) * s.sep_here));
+    const __m256d no_gain (
+        _mm256_set1_pd (-std::numeric_limits<double>::infinity ()));
+    __m256d left (_mm256_setzero_pd ());
+    __m256d right (_mm256_set_pd (
+            s.n_bg_total, s.n_sig_total, s.w_bg_total, s.w_sig_total));
+    int i (0);
+    for (; i + 4 <= n_cuts; i += 4) {
+        __m256d l[4], r[4];
+        for (int k (0); k < 4; ++k) {
+            const int j (s.stride * (i + k));
+            const __m256d bin (_mm256_set_pd (
+                    s.n_bg[j], s.n_sig[j], s.w_bg[j], s.w_sig[j]));
+            left = _mm256_add_pd (left, bin);
+            right = _mm256_sub_pd (right, bin);
+            l[k] = left;
+            r[k] = right;
+        }
+        // now l[0] holds w_sig_left for cuts i ... i + 3, l[1] w_bg_left,
+        // and so on
+        transpose4 (l);
+        transpose4 (r);
+        const __m256d w_left (_mm256_add_pd (l[0], l[1]));
+        const __m256d w_right (_mm256_add_pd (r[0], r[1]));
+        const __m256d ok (_mm256_and_pd (
+                _mm256_cmp_pd (
+                    _mm256_add_pd (l[2], l[3]), min_split, _CMP_GE_OQ),
+                _mm256_cmp_pd (
+                    _mm256_add_pd (r[2], r[3]), min_split, _CMP_GE_OQ)));
+        const __m256d gain (_mm256_sub_pd (
+                _mm256_sub_pd (
+                    w_sep_here,
+                    _mm256_mul_pd (
+                        w_left,
+                        sep.value (_mm256_div_pd (l[0], w_left)))),
+                _mm256_mul_pd (
+                    w_right,
+                    sep.value (_mm256_div_pd (r[0], w_right)))));
+        _mm256_storeu_pd (&s.gain[i], _mm256_blendv_pd (no_gain, gain, ok));
+    }
+    double left_sums[4], right_sums[4];
+    _mm256_storeu_pd (left_sums, left);
+    _mm256_storeu_pd (right_sums, right);
+    scan_gains (sep, s, i, n_cuts, left_sums, right_sums);
+}
+
+#endif  /* PYBDT_SCAN_AVX2 */
+
+// take the first of cuts [0, n_cuts) with the largest gain, if it beats
+// best_gain
+inline void
+take_best_cut (SplitScan& s, int n_cuts)
+{
+    for (int i (0); i < n_cuts; ++i) {
+        if (s.gain[i] > s.best_gain) {
+            s.best_gain = s.gain[i];
+            s.best_bin = i;
+        }
+    }
+}
+
+// Scan for criterion Sep, whose value (p) is inlined.  The gains of all
+// cuts are computed first, then the first cut with the largest gain is
+// taken.
+template <typename Sep>
+void
+scan_split (const Sep& sep, SplitScan& s)
+{
+    const int n_cuts (std::max (s.n_bins - 1, 0));
+    s.gain.resize (n_cuts);
+    const double left[4] = {0, 0, 0, 0};
+    const double right[4] = {
+        s.w_sig_total, s.w_bg_total, s.n_sig_total, s.n_bg_total};
+    scan_gains (sep, s, 0, n_cuts, left, right);
+    take_best_cut (s, n_cuts);
+}
+
+template <typename Sep>
+void
+scan_split_as (const SepFunc& sep, SplitScan& scan)
+{
+    scan_split (static_cast<const Sep&> (sep), scan);
+}
+
+#ifdef PYBDT_SCAN_AVX2
+
+// scan_split with the gains computed four cuts at a time
+template <typename Sep>
+PYBDT_TARGET_AVX2 void
+scan_split_avx2 (const Sep& sep, SplitScan& s)
+{
+    const int n_cuts (std::max (s.n_bins - 1, 0));
+    s.gain.resize (n_cuts);
+    scan_gains_avx2 (sep, s, n_cuts);
+    take_best_cut (s, n_cuts);
+}
+
+template <typename Sep>
+void
+scan_split_avx2_as (const SepFunc& sep, SplitScan& scan)
+{
+    scan_split_avx2 (static_cast<const Sep&> (sep), scan);
+}
+
+#endif  /* PYBDT_SCAN_AVX2 */
+
+// the scan for criterion Sep: the AVX2 one where this CPU has it
+template <typename Sep>
+SplitScanFunc
+split_scan_for ()
+{
+#ifdef PYBDT_SCAN_AVX2
+    if (cpu_has_avx2 ()) {
+        return &scan_split_avx2_as<Sep>;
+    }
+#endif
+    return &scan_split_as<Sep>;
+}
+
+
+// A separation criterion as a function of purity.  Each criterion has a
+// static value (p) for the specialized scan; value (p) here is the
+// virtual fallback for criteria that do not.
+struct SepFunc {
+    virtual double operator() (double p) const = 0;
+    virtual std::string separation_type () const = 0;
+
+    double value (double p) const
+    {
+        return (*this) (p);
+    }
+
+#ifdef PYBDT_SCAN_AVX2
+    PYBDT_TARGET_AVX2 __m256d value (__m256d p) const
+    {
+        double lanes[4];
+        _mm256_storeu_pd (lanes, p);
+        for (int k (0); k < 4; ++k) {
+            lanes[k] = (*this) (lanes[k]);
+        }
+        return _mm256_loadu_pd (lanes);
+    }
+#endif
+
+    virtual SplitScanFunc split_scan () const
+    {
+        return split_scan_for<SepFunc> ();
+    }
+};
+struct SepGini : public SepFunc {
+    static double value (double p);
+#ifdef PYBDT_SCAN_AVX2
+    PYBDT_TARGET_AVX2 static __m256d value (__m256d p);
+#endif
+    virtual double operator() (double p) const;
+    virtual std::string separation_type () const;
+    virtual SplitScanFunc split_scan () const;
+};
+struct SepCrossEntropy : public SepFunc {
+    static double value (double p);
+#ifdef PYBDT_SCAN_AVX2
+    PYBDT_TARGET_AVX2 static __m256d value (__m256d p);
+#endif
+    virtual double operator() (double p) const;
+    virtual std::string separation_type () const;
+    virtual SplitScanFunc split_scan () const;
+};
+struct SepMisclassError : public SepFunc {
+    static double value (double p);
+#ifdef PYBDT_SCAN_AVX2
+    PYBDT_TARGET_AVX2 static __m256d value (__m256d p);
+#endif
+    virtual double operator() (double p) const;
+    virtual std::string separation_type () const;
+    virtual SplitScanFunc split_scan () const;
+};
+
+struct SumSquaredError : public SepFunc {
+    static double value (double p);
+#ifdef PYBDT_SCAN_AVX2
+    PYBDT_TARGET_AVX2 static __m256d value (__m256d p);
+#endif
+    virtual double operator() (double p) const;
+    virtual std::string separation_type () const;
+    virtual SplitScanFunc split_scan () const;
+};
+
+inline double SepGini::value (double p)
+{
+    return p * (1 - p);
+}
+#ifdef PYBDT_SCAN_AVX2
+PYBDT_TARGET_AVX2 inline __m256d SepGini::value (__m256d p)
+{
+    return _mm256_mul_pd (p, _mm256_sub_pd (_mm256_set1_pd (1), p));
+}
+#endif
+inline double SepGini::operator() (double p) const
+{
+    return value (p);
+}
+inline std::string SepGini::separation_type () const
+{
+    return "gini";
+}
+inline SplitScanFunc SepGini::split_scan () const
+{
+    return split_scan_for<SepGini> ();
+}
+
+// pure nodes have zero entropy (rather than 0 * log (0) = NaN)
+inline double SepCrossEntropy::value (double p)
+{
+    using std::log;
+    if (p <= 0 or p >= 1) {
+        return 0;
+    }
+    return -p * log (p) - (1-p) * log (1 - p);
+}
+#ifdef PYBDT_SCAN_AVX2
+PYBDT_TARGET_AVX2 inline __m256d SepCrossEntropy::value (__m256d p)
+{
+    // no vector log in the standard intrinsics
+    double lanes[4];
+    _mm256_storeu_pd (lanes, p);
+    for (int k (0); k < 4; ++k) {
+        lanes[k] = value (lanes[k]);
+    }
+    return _mm256_loadu_pd (lanes);
+}
+#endif
+inline double SepCrossEntropy::operator() (double p) const
+{
+    return value (p);
+}
+inline std::string SepCrossEntropy::separation_type () const
+{
+    return "cross_entropy";
+}
+inline SplitScanFunc SepCrossEntropy::split_scan () const
+{
+    return split_scan_for<SepCrossEntropy> ();
+}
+
+inline double SepMisclassError::value (double p)
+{
+    return 1 - std::max (p, 1-p);
+}
+#ifdef PYBDT_SCAN_AVX2
+PYBDT_TARGET_AVX2 inline __m256d SepMisclassError::value (__m256d p)
+{
+    const __m256d one (_mm256_set1_pd (1));
+    return _mm256_sub_pd (one, _mm256_max_pd (p, _mm256_sub_pd (one, p)));
+}
+#endif
+inline double SepMisclassError::operator() (double p) const
+{
+    return value (p);
+}
+inline std::string SepMisclassError::separation_type () const
+{
+    return "misclass_error";
+}
+inline SplitScanFunc SepMisclassError::split_scan () const
+{
+    return split_scan_for<SepMisclassError> ();
+}
+
+//Pretty dumb to just return the input value, but it works for now
+inline double SumSquaredError::value (double p)
+{
+    return p;
+}
+#ifdef PYBDT_SCAN_AVX2
+PYBDT_TARGET_AVX2 inline __m256d SumSquaredError::value (__m256d p)
+{
+    return p;
+}
+#endif
+inline double SumSquaredError::operator() (double p) const
+{
+    return value (p);
+}
+inline std::string SumSquaredError::separation_type () const
+{
+    return "sumsquared_error";
+}
+inline SplitScanFunc SumSquaredError::split_scan () const
+{
+    return split_scan_for<SumSquaredError> ();
+}
+
+
+#endif  /* PYBDT_SEPARATION_HPP */
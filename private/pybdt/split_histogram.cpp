@@ -0,0 +1,143 @@
+// split_histogram.cpp
+
+
+#include "split_histogram.hpp"
+
+#include <cassert>
+
+using namespace std;
+
+
+SplitHistogram::SplitHistogram (double min_val, double max_val, int n_bins)
+:   m_min_val (min_val), m_max_val (max_val), m_n_bins (n_bins),
+    m_bin_width ((max_val - min_val) / n_bins),
+    m_bins (N_SUMS * n_bins)
+{
+}
+
+SplitHistogram::~SplitHistogram ()
+{
+}
+
+const double*
+SplitHistogram::bins () const
+{
+    return &m_bins[0];
+}
+
+double
+SplitHistogram::min_val () const
+{
+    return m_min_val;
+}
+
+double
+SplitHistogram::max_val () const
+{
+    return m_max_val;
+}
+
+int
+SplitHistogram::n_bins () const
+{
+    return m_n_bins;
+}
+
+void
+SplitHistogram::fill_sig (const vector<Event>& events,
+                          const vector<double>& weights, int i_f)
+{
+    fill (events, weights, i_f, W_SIG);
+}
+
+void
+SplitHistogram::fill_bg (const vector<Event>& events,
+                         const vector<double>& weights, int i_f)
+{
+    fill (events, weights, i_f, W_BG);
+}
+
+void
+SplitHistogram::fill (const vector<Event>& events,
+                      const vector<double>& weights, int i_f, int w_offset)
+{
+    assert (events.size () == weights.size ());
+    const int n_offset (w_offset + N_SIG - W_SIG);
+    const size_t n_events (events.size ());
+    for (size_t i (0); i < n_events; ++i) {
+        const int i_bin (index_for_value (events[i].value (i_f)));
+        if (i_bin >= 0) {
+            double* bin (&m_bins[N_SUMS * i_bin]);
+            bin[w_offset] += weights[i];
+            bin[n_offset] += 1;
+        }
+    }
+}
+
+double
+SplitHistogram::value_for_index (int i) const
+{
+    return m_min_val + i * m_bin_width;  // left edge value
+}
+
+
+GradientHistogram::GradientHistogram (double min_val, double max_val,
+                                      int n_bins)
+:   m_min_val (min_val), m_max_val (max_val), m_n_bins (n_bins),
+    m_bin_width ((max_val - min_val) / n_bins),
+    m_bins (N_SUMS * n_bins)
+{
+}
+
+GradientHistogram::GradientHistogram (const vector<double>& bin_edges)
+:   m_min_val (bin_edges.front ()), m_max_val (bin_edges.back ()),
+    m_n_bins (bin_edges.size () - 1),
+    m_bin_width (0),
+    m_bin_edges (bin_edges),
+    m_bins (N_SUMS * m_n_bins)
+{
+    assert (bin_edges.size () >= 2);
+}
+
+GradientHistogram::~GradientHistogram ()
+{
+}
+
+const double*
+GradientHistogram::bins () const
+{
+    return &m_bins[0];
+}
+
+int
+GradientHistogram::n_bins () const
+{
+    return m_n_bins;
+}
+
+void
+GradientHistogram::fill (const vector<Event>& events,
+                         const vector<double>& g, const vector<double>& h,
+                         int i_f)
+{
+    assert (events.size () == g.size () and events.size () == h.size ());
+    const size_t n_events (events.size ());
+    for (size_t i (0); i < n_events; ++i) {
+        const int i_bin (index_for_value (events[i].value (i_f)));
+        if (i_bin >= 0) {
+            double* bin (&m_bins[N_SUMS * i_bin]);
+            bin[G] += g[i];
+            bin[H] += h[i];
+            bin[N] += 1;
+        }
+    }
+}
+
+double
+GradientHistogram::value_for_index (int i) const
+{
+    if (m_bin_edges.empty ()) {
+        return m_min_val + i * m_bin_width;  // left edge value
+    }
+    return m_bin_edges[i];
+}
@@ -0,0 +1,132 @@
+// split_histogram.hpp
+
+
+#ifndef PYBDT_SPLIT_HISTOGRAM_HPP
+#define PYBDT_SPLIT_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "dataset.hpp"
+
+// A linear histogram of everything the split scan needs for one feature:
+// signal and background weight and count, interleaved per bin so that a
+// single pass over the events fills all four.  Binning matches
+// LinearHistogram; values outside [min_val, max_val) are dropped.
+class SplitHistogram {
+public:
+
+    // offsets of the sums within a bin
+    enum { W_SIG, W_BG, N_SIG, N_BG, N_SUMS };
+
+    SplitHistogram (double min_val, double max_val, int n_bins);
+    ~SplitHistogram ();
+
+    // the sums of bin i start at bins ()[N_SUMS * i]
+    const double* bins () const;
+    double min_val () const;
+    double max_val () const;
+    int n_bins () const;
+
+    // add weight and count of each event, reading feature i_f directly
+    void fill_sig (const std::vector<Event>& events,
+                   const std::vector<double>& weights, int i_f);
+    void fill_bg (const std::vector<Event>& events,
+                  const std::vector<double>& weights, int i_f);
+
+    int index_for_value (double value) const;
+
+    double value_for_index (int i) const;
+
+
+private:
+
+    void fill (const std::vector<Event>& events,
+               const std::vector<double>& weights, int i_f, int w_offset);
+
+    double m_min_val;
+    double m_max_val;
+    int m_n_bins;
+
+    double m_bin_width;
+
+    std::vector<double> m_bins;
+
+};
+
+
+inline int
+SplitHistogram::index_for_value (double value) const
+{
+    if (m_min_val <= value and value < m_max_val) {
+        return std::min (int ((value - m_min_val) / m_bin_width),
+                         m_n_bins - 1);
+    }
+    else {
+        return -1;
+    }
+}
+
+
+// The Newton boosting counterpart of SplitHistogram: gradient, hessian
+// and count, interleaved per bin.  Bins are either linear over
+// [min_val, max_val) or given by explicit edges, which may then be
+// shared by every node of a tree.
+class GradientHistogram {
+public:
+
+    // offsets of the sums within a bin
+    enum { G, H, N, N_SUMS };
+
+    GradientHistogram (double min_val, double max_val, int n_bins);
+    explicit GradientHistogram (const std::vector<double>& bin_edges);
+    ~GradientHistogram ();
+
+    // the sums of bin i start at bins ()[N_SUMS * i]
+    const double* bins () const;
+    int n_bins () const;
+
+    // add gradient, hessian and count of each event, reading feature i_f
+    // directly
+    void fill (const std::vector<Event>& events,
+               const std::vector<double>& g, const std::vector<double>& h,
+               int i_f);
+
+    int index_for_value (double value) const;
+
+    double value_for_index (int i) const;
+
+
+private:
+
+    double m_min_val;
+    double m_max_val;
+    int m_n_bins;
+
+    double m_bin_width;
+
+    // empty for linear bins
+    std::vector<double> m_bin_edges;
+
+    std::vector<double> m_bins;
+
+};
+
+
+inline int
+GradientHistogram::index_for_value (double value) const
+{
+    if (not (m_min_val <= value and value < m_max_val)) {
+        return -1;
+    }
+    if (m_bin_edges.empty ()) {
+        return std::min (int ((value - m_min_val) / m_bin_width),
+                         m_n_bins - 1);
+    }
+    // last bin whose left edge is <= value, as NonlinearHistogram
+    return std::upper_bound (m_bin_edges.begin (), m_bin_edges.end (), value)
+        - m_bin_edges.begin () - 1;
+}
+
+
+#endif  /* PYBDT_SPLIT_HISTOGRAM_HPP */
@@ -0,0 +1,144 @@
+// training_log.cpp
+
+#include "training_log.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/make_shared.hpp>
+
+
+using namespace std;
+using namespace boost;
+
+
+TrainingLog::TrainingLog (Level level)
+    : m_level (level), m_stream (cerr)
+{
+}
+
+TrainingLog::TrainingLog (Level level, ostream& stream)
+    : m_level (level), m_stream (stream)
+{
+}
+
+TrainingLog::Level
+TrainingLog::level () const
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    return m_level;
+}
+
+bool
+TrainingLog::enabled (Level level) const
+{
+    return level != NONE and level <= this->level ();
+}
+
+vector<TreeRecord>
+TrainingLog::records () const
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    return m_records;
+}
+
+TrainingLog::Level
+TrainingLog::level_from_string (const string& name)
+{
+    if (name == "none") {
+        return NONE;
+    }
+    else if (name == "info") {
+        return INFO;
+    }
+    else if (name == "tree") {
+        return TREE;
+    }
+    else if (name == "debug") {
+        return DEBUG;
+    }
+    throw runtime_error ("unknown log level \"" + name + "\"");
+}
+
+string
+TrainingLog::level_to_string (Level level)
+{
+    switch (level) {
+    case NONE:
+        return "none";
+    case INFO:
+        return "info";
+    case TREE:
+        return "tree";
+    default:
+        return "debug";
+    }
+}
+
+void
+TrainingLog::level (Level level)
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    m_level = level;
+}
+
+void
+TrainingLog::callback (const Callback& callback)
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    if (callback) {
+        m_callback = boost::make_shared<Callback> (callback);
+    }
+    else {
+        m_callback.reset ();
+    }
+}
+
+void
+TrainingLog::clear ()
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    m_records.clear ();
+}
+
+void
+TrainingLog::message (Level level, const string& msg)
+{
+    if (not enabled (level)) {
+        return;
+    }
+    // build the line first so concurrent trainings do not interleave
+    ostringstream o;
+    o << "[" << level_to_string (level) << "] " << msg << '\n';
+    boost::mutex::scoped_lock lock (m_mutex);
+    m_stream << o.str () << flush;
+}
+
+void
+TrainingLog::tree (const TreeRecord& record)
+{
+    boost::shared_ptr<Callback> callback;
+    {
+        boost::mutex::scoped_lock lock (m_mutex);
+        m_records.push_back (record);
+        callback = m_callback;
+    }
+    if (enabled (TREE)) {
+        ostringstream o;
+        if (record.run.size ()) {
+            o << record.run << ": ";
+        }
+        o << "tree " << record.tree + 1 << " of " << record.num_trees
+            << ": error " << record.error << ", alpha " << record.alpha
+            << ", " << record.n_leaves << " leaves, depth "
+            << record.max_depth << ", " << fixed << setprecision (3)
+            << record.seconds << " s";
+        message (TREE, o.str ());
+    }
+    // called outside the lock, so it may use the log itself
+    if (callback) {
+        (*callback) (record);
+    }
+}
@@ -0,0 +1,83 @@
+// training_log.hpp
+// levelled messages and per-tree records from a running training
+
+
+#ifndef PYBDT_TRAINING_LOG_HPP
+#define PYBDT_TRAINING_LOG_HPP
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+
+// summary of one boosting iteration
+struct TreeRecord {
+    // the training the tree belongs to: empty for a single training,
+    // else e.g. "fold 2" or "fold 2/window 5" for one of several run at
+    // once with the same log
+    std::string run;
+    int tree;
+    int num_trees;
+    // weighted misclassification rate (adaboost) or training loss (newton)
+    double error;
+    // tree weight (adaboost) or learning rate (newton)
+    double alpha;
+    int n_leaves;
+    int max_depth;
+    double seconds;
+};
+
+
+// Shared by every training run with it, possibly from several threads at
+// once.  Messages at or below the current level go to the stream; every
+// TreeRecord is kept and passed to the callback, if any, whatever the
+// level.  Nothing is logged per event or per node above level DEBUG.
+// BDTLearner clears the records when a top-level training starts (see
+// Learner::start_training), so they cover the latest training only.
+class TrainingLog : boost::noncopyable {
+public:
+
+    enum Level { NONE, INFO, TREE, DEBUG };
+
+    typedef boost::function<void (const TreeRecord&)> Callback;
+
+    // structors
+
+    explicit TrainingLog (Level level=INFO);
+    TrainingLog (Level level, std::ostream& stream);
+
+    // inspectors
+
+    Level level () const;
+    bool enabled (Level level) const;
+    std::vector<TreeRecord> records () const;
+
+    static Level level_from_string (const std::string& name);
+    static std::string level_to_string (Level level);
+
+    // mutators
+
+    void level (Level level);
+    void callback (const Callback& callback);
+    void clear ();
+
+    void message (Level level, const std::string& msg);
+    void tree (const TreeRecord& record);
+
+private:
+
+    mutable boost::mutex m_mutex;
+    Level m_level;
+    std::ostream& m_stream;
+    boost::shared_ptr<Callback> m_callback;
+    std::vector<TreeRecord> m_records;
+
+};
+
+
+#endif  /* PYBDT_TRAINING_LOG_HPP */
@@ -0,0 +1,121 @@
+// training_profile.cpp
+
+#include "training_profile.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/thread/thread.hpp>
+
+
+using namespace std;
+using namespace boost;
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+
+TrainingProfile::TrainingProfile ()
+    : m_origin (microsec_clock::universal_time ())
+{
+}
+
+map<string, TrainingProfile::Phase>
+TrainingProfile::phases () const
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    return m_phases;
+}
+
+string
+TrainingProfile::chrome_trace () const
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    ostringstream o;
+    o << "{\"traceEvents\":[";
+    for (size_t i (0); i < m_spans.size (); ++i) {
+        const Span& span (m_spans[i]);
+        o << (i ? ",\n" : "\n")
+            << "{\"name\":\"" << span.phase << "\",\"ph\":\"X\""
+            << ",\"ts\":" << span.start_us
+            << ",\"dur\":" << span.duration_us
+            << ",\"pid\":0,\"tid\":" << span.thread
+            << ",\"args\":{\"events\":" << span.events
+            << ",\"est_bytes\":" << span.est_bytes << "}}";
+    }
+    o << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return o.str ();
+}
+
+void
+TrainingProfile::add (const char* phase, const ptime& start, const ptime& end,
+                      long events, long est_bytes)
+{
+    const long duration_us ((end - start).total_microseconds ());
+    ostringstream thread_name;
+    thread_name << boost::this_thread::get_id ();
+    boost::mutex::scoped_lock lock (m_mutex);
+    Phase& totals (m_phases[phase]);
+    totals.seconds += duration_us / 1e6;
+    totals.calls += 1;
+    totals.events += events;
+    totals.est_bytes += est_bytes;
+    if (m_spans.size () < max_spans) {
+        // small, stable thread numbers read better in the trace viewer
+        const int n_threads (m_threads.size ());
+        const int thread (
+            m_threads.insert (make_pair (thread_name.str (), n_threads))
+            .first->second);
+        Span span = {
+            phase, (start - m_origin).total_microseconds (), duration_us,
+            thread, events, est_bytes};
+        m_spans.push_back (span);
+    }
+}
+
+void
+TrainingProfile::clear ()
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    m_origin = microsec_clock::universal_time ();
+    m_phases.clear ();
+    m_spans.clear ();
+    m_threads.clear ();
+}
+
+
+ProfileScope::ProfileScope (TrainingProfile* profile, const char* phase,
+                            long events, long est_bytes)
+    : m_profile (profile), m_phase (phase),
+    m_events (events), m_est_bytes (est_bytes)
+{
+    if (m_profile) {
+        m_start = microsec_clock::universal_time ();
+    }
+}
+
+ProfileScope::~ProfileScope ()
+{
+    stop ();
+}
+
+void
+ProfileScope::stop ()
+{
+    if (m_profile) {
+        m_profile->add (m_phase, m_start, microsec_clock::universal_time (),
+                        m_events, m_est_bytes);
+        m_profile = 0;
+    }
+}
+
+void
+ProfileScope::add_events (long events)
+{
+    m_events += events;
+}
+
+void
+ProfileScope::add_est_bytes (long est_bytes)
+{
+    m_est_bytes += est_bytes;
+}
@@ -0,0 +1,101 @@
+// training_profile.hpp
+// per-phase timing and counters for training
+
+
+#ifndef PYBDT_TRAINING_PROFILE_HPP
+#define PYBDT_TRAINING_PROFILE_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+
+// Cumulative wall time, call count, events touched and estimated bytes
+// allocated for each named phase of a training, plus the individual spans
+// for a Chrome trace (chrome://tracing, Perfetto).  Safe to share between
+// concurrent trainings.
+//
+// The byte figures are not measured: each phase passes in an estimate
+// from the sizes of the containers it creates, to compare phases and
+// settings rather than to account for memory exactly.
+class TrainingProfile : boost::noncopyable {
+public:
+
+    struct Phase {
+        double seconds;
+        long calls;
+        long events;
+        long est_bytes;
+    };
+
+    // spans beyond this many are only counted in the totals
+    static const size_t max_spans = 100000;
+
+    // structors
+
+    TrainingProfile ();
+
+    // inspectors
+
+    std::map<std::string, Phase> phases () const;
+    std::string chrome_trace () const;
+
+    // mutators
+
+    void add (const char* phase,
+              const boost::posix_time::ptime& start,
+              const boost::posix_time::ptime& end,
+              long events, long est_bytes);
+    void clear ();
+
+private:
+
+    struct Span {
+        const char* phase;
+        long start_us;
+        long duration_us;
+        int thread;
+        long events;
+        long est_bytes;
+    };
+
+    mutable boost::mutex m_mutex;
+    boost::posix_time::ptime m_origin;
+    std::map<std::string, Phase> m_phases;
+    std::vector<Span> m_spans;
+    std::map<std::string, int> m_threads;
+
+};
+
+
+// Times its own lifetime as one call of phase, which must be a string
+// literal.  Does nothing, not even read the clock, if profile is null.
+class ProfileScope : boost::noncopyable {
+public:
+
+    ProfileScope (TrainingProfile* profile, const char* phase,
+                  long events=0, long est_bytes=0);
+    ~ProfileScope ();
+
+    void add_events (long events);
+    void add_est_bytes (long est_bytes);
+
+    // end the call now rather than at destruction
+    void stop ();
+
+private:
+
+    TrainingProfile* m_profile;
+    const char* m_phase;
+    long m_events;
+    long m_est_bytes;
+    boost::posix_time::ptime m_start;
+
+};
+
+
+#endif  /* PYBDT_TRAINING_PROFILE_HPP */
@@ -0,0 +1,88 @@
+// training_status.cpp
+
+#include "training_status.hpp"
+
+
+using namespace std;
+
+
+TrainingCancelled::TrainingCancelled ()
+    : runtime_error ("training cancelled")
+{
+}
+
+
+TrainingStatus::TrainingStatus ()
+    : m_parent (0), m_begin (0), m_end (1),
+    m_cancelled (false), m_progress (0)
+{
+}
+
+TrainingStatus::TrainingStatus (TrainingStatus* parent,
+                                double begin, double end)
+    : m_parent (parent), m_begin (begin), m_end (end),
+    m_cancelled (false), m_progress (0)
+{
+}
+
+bool
+TrainingStatus::cancelled () const
+{
+    if (m_parent) {
+        return m_parent->cancelled ();
+    }
+    boost::mutex::scoped_lock lock (m_mutex);
+    return m_cancelled;
+}
+
+double
+TrainingStatus::progress () const
+{
+    boost::mutex::scoped_lock lock (m_mutex);
+    return m_progress;
+}
+
+void
+TrainingStatus::check () const
+{
+    if (cancelled ()) {
+        throw TrainingCancelled ();
+    }
+}
+
+void
+TrainingStatus::cancel ()
+{
+    if (m_parent) {
+        m_parent->cancel ();
+        return;
+    }
+    boost::mutex::scoped_lock lock (m_mutex);
+    m_cancelled = true;
+}
+
+void
+TrainingStatus::progress (double fraction)
+{
+    double delta;
+    {
+        boost::mutex::scoped_lock lock (m_mutex);
+        delta = fraction - m_progress;
+        m_progress = fraction;
+    }
+    if (m_parent) {
+        m_parent->add_progress (delta * (m_end - m_begin));
+    }
+}
+
+void
+TrainingStatus::add_progress (double delta)
+{
+    {
+        boost::mutex::scoped_lock lock (m_mutex);
+        m_progress += delta;
+    }
+    if (m_parent) {
+        m_parent->add_progress (delta * (m_end - m_begin));
+    }
+}
@@ -0,0 +1,63 @@
+// training_status.hpp
+// progress reporting and cancellation for a running training
+
+
+#ifndef PYBDT_TRAINING_STATUS_HPP
+#define PYBDT_TRAINING_STATUS_HPP
+
+#include <stdexcept>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+
+// thrown from inside a Learner when its TrainingStatus has been cancelled
+class TrainingCancelled : public std::runtime_error {
+public:
+    TrainingCancelled ();
+};
+
+
+// Shared between a running training and whoever is watching it.
+//
+// A Learner which trains sub-models can hand each one a child status
+// covering a slice [begin, end) of its own progress; cancelling the root
+// cancels every child.  Children pass on changes in their progress, so
+// children over disjoint slices may run concurrently.
+class TrainingStatus : boost::noncopyable {
+public:
+
+    // structors
+
+    TrainingStatus ();
+    TrainingStatus (TrainingStatus* parent, double begin, double end);
+
+    // inspectors
+
+    bool cancelled () const;
+    double progress () const;
+
+    // throw TrainingCancelled if cancelled
+    void check () const;
+
+    // mutators
+
+    void cancel ();
+    void progress (double fraction);
+
+private:
+
+    void add_progress (double delta);
+
+    TrainingStatus* m_parent;
+    double m_begin;
+    double m_end;
+
+    mutable boost::mutex m_mutex;
+    bool m_cancelled;
+    double m_progress;
+
+};
+
+
+#endif  /* PYBDT_TRAINING_STATUS_HPP */
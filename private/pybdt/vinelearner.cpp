@@ -1,22 +1,29 @@
-// bdtlearner.cpp
-
-#include <Python.h>
+// vinelearner.cpp
 
 #include "vinelearner.hpp"
 #include "np.hpp"
 
 #include "notifier.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/pointer_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
+#include "parallel.hpp"
 #include "vinemodel.hpp"
 
 
 using namespace std;
 using namespace boost;
-namespace py = boost::python;
 
 
 VineLearner::VineLearner (const string& vine_feature,
@@ -32,6 +39,9 @@ VineLearner::VineLearner (const string& vine_feature,
     m_vine_feature_max (vine_feature_max),
     m_vine_feature_width (vine_feature_width),
     m_vine_feature_step (vine_feature_step),
+    m_quiet (false),
+    m_num_threads (1),
+    m_window_events (0),
     m_learner (learner)
 {
     for (size_t i (0); i < m_feature_names.size (); ++i) {
@@ -52,6 +62,18 @@ VineLearner::quiet () const {
     return m_quiet;
 }
 
+int
+VineLearner::num_threads () const
+{
+    return m_num_threads;
+}
+
+int
+VineLearner::window_events () const
+{
+    return m_window_events;
+}
+
 string
 VineLearner::vine_feature () const
 {
@@ -94,6 +116,18 @@ VineLearner::quiet (bool val) {
     m_quiet = val;
 }
 
+void
+VineLearner::num_threads (int n)
+{
+    m_num_threads = n;
+}
+
+void
+VineLearner::window_events (int n)
+{
+    m_window_events = n;
+}
+
 void
 VineLearner::vine_feature (const string& vine_feature)
 {
@@ -125,103 +159,267 @@ VineLearner::vine_feature_step (const double vine_feature_step)
 }
 
 
+namespace {
+
+// The events sorted once by the vine feature, so that every window is a
+// contiguous slice found by binary search.  Events with a non-finite vine
+// feature fall in no window and are left out.
+struct VineIndex {
+    VineIndex (const vector<Event>& events, int vine_feature_i)
+    {
+        vector<pair<double,int> > sorted;
+        sorted.reserve (events.size ());
+        for (size_t i (0); i < events.size (); ++i) {
+            const double value (events[i].value (vine_feature_i));
+            if (isfinite (value)) {
+                sorted.push_back (make_pair (value, int (i)));
+            }
+        }
+        sort (sorted.begin (), sorted.end ());
+        values.reserve (sorted.size ());
+        order.reserve (sorted.size ());
+        for (size_t j (0); j < sorted.size (); ++j) {
+            values.push_back (sorted[j].first);
+            order.push_back (sorted[j].second);
+        }
+    }
+
+    // indices of the events in [feature_min, feature_max), in input order
+    // so that each window trains exactly as if it had been filtered
+    vector<int> window (double feature_min, double feature_max) const
+    {
+        const size_t lo (lower_bound (values.begin (), values.end (),
+                                      feature_min) - values.begin ());
+        const size_t hi (lower_bound (values.begin () + lo, values.end (),
+                                      feature_max) - values.begin ());
+        vector<int> out (order.begin () + lo,
+                         order.begin () + max (lo, hi));
+        sort (out.begin (), out.end ());
+        return out;
+    }
+
+    // values[j] is the vine feature of event order[j]
+    vector<double> values;
+    vector<int> order;
+};
+
+// Windows holding window_events events each (sig and bg together), the
+// next starting step_events events after the previous one, within
+// [feature_min, feature_max).  Edges fall on event values, so windows
+// sharing a value at an edge may differ slightly from the target.
+void
+quantile_windows (const VineIndex& sig_index, const VineIndex& bg_index,
+                  double feature_min, double feature_max,
+                  int window_events, int step_events,
+                  vector<double>& bin_mins, vector<double>& bin_maxs)
+{
+    vector<double> values;
+    values.reserve (sig_index.values.size () + bg_index.values.size ());
+    merge (sig_index.values.begin (), sig_index.values.end (),
+           bg_index.values.begin (), bg_index.values.end (),
+           back_inserter (values));
+    const vector<double>::iterator lo (
+        lower_bound (values.begin (), values.end (), feature_min));
+    const vector<double>::iterator hi (
+        lower_bound (lo, values.end (), feature_max));
+    values = vector<double> (lo, hi);
+    const int n (values.size ());
+    for (int start (0); start < n; start += step_events) {
+        const int end (start + window_events);
+        const double bin_min (start ? values[start] : feature_min);
+        const double bin_max (end < n ? values[end] : feature_max);
+        if (bin_min < bin_max) {
+            bin_mins.push_back (bin_min);
+            bin_maxs.push_back (bin_max);
+        }
+        if (end >= n) {
+            break;
+        }
+    }
+}
+
+// trains window i for parallel::parallel_for
+struct WindowTrainer {
+    WindowTrainer (const Learner& learner,
+                   const VineIndex& sig_index, const VineIndex& bg_index,
+                   const vector<Event>& sig, const vector<Event>& bg,
+                   const vector<double>& sig_weights,
+                   const vector<double>& bg_weights,
+                   const vector<double>& bin_mins,
+                   const vector<double>& bin_maxs,
+                   const string& run,
+                   TrainingStatus* status,
+                   Notifier<int>* notifier,
+                   vector<boost::shared_ptr<Model> >& models)
+        : learner (learner), sig_index (sig_index), bg_index (bg_index),
+        sig (sig), bg (bg), sig_weights (sig_weights), bg_weights (bg_weights),
+        bin_mins (bin_mins), bin_maxs (bin_maxs), run (run),
+        status (status), notifier (notifier), n_done (0), models (models)
+    { }
+
+    // gather the events of window i_window and their weights
+    void select (const VineIndex& index,
+                 const vector<Event>& events, const vector<double>& weights,
+                 int i_window,
+                 vector<Event>& bin_events, vector<double>& bin_weights)
+    {
+        const vector<int> window (
+            index.window (bin_mins[i_window], bin_maxs[i_window]));
+        bin_events.reserve (window.size ());
+        bin_weights.reserve (window.size ());
+        for (size_t j (0); j < window.size (); ++j) {
+            bin_events.push_back (events[window[j]]);
+            bin_weights.push_back (weights[window[j]]);
+        }
+    }
+
+    void operator() (int i_window)
+    {
+        if (status) {
+            status->check ();
+        }
+        vector<Event> bin_sig, bin_bg;
+        vector<double> bin_sig_weights, bin_bg_weights;
+        select (sig_index, sig, sig_weights, i_window,
+                bin_sig, bin_sig_weights);
+        select (bg_index, bg, bg_weights, i_window,
+                bin_bg, bin_bg_weights);
+        const int n_windows (models.size ());
+        TrainingStatus bin_status (
+            status, 1. * i_window / n_windows, (i_window + 1.) / n_windows);
+        ostringstream bin_run;
+        if (run.size ()) {
+            bin_run << run << "/";
+        }
+        bin_run << "window " << i_window;
+        // the windows' own learners stay silent and never checkpoint;
+        // the vine notifier and status report for all of them
+        models[i_window] = learner.train_quietly (
+            bin_sig, bin_bg, bin_sig_weights, bin_bg_weights,
+            bin_run.str (), status ? &bin_status : 0);
+        if (status) {
+            bin_status.progress (1);
+        }
+        if (notifier) {
+            boost::mutex::scoped_lock lock (mutex);
+            notifier->update (++n_done);
+        }
+    }
+
+    const Learner& learner;
+    const VineIndex& sig_index;
+    const VineIndex& bg_index;
+    const vector<Event>& sig;
+    const vector<Event>& bg;
+    const vector<double>& sig_weights;
+    const vector<double>& bg_weights;
+    const vector<double>& bin_mins;
+    const vector<double>& bin_maxs;
+    const string& run;
+    TrainingStatus* status;
+    Notifier<int>* notifier;
+    boost::mutex mutex;
+    int n_done;
+    vector<boost::shared_ptr<Model> >& models;
+};
+
+}
+
 boost::shared_ptr<Model>
 VineLearner::train_given_everything (
     const vector<Event>& sig, const vector<Event>& bg,
     const vector<double>& init_sig_weights,
-    const vector<double>& init_bg_weights) const
+    const vector<double>& init_bg_weights,
+    TrainingStatus* status) const
 {
-    // some types
-    typedef vector<boost::shared_ptr<Model> > vecm;
-    typedef vector<Event> vecev;
-    typedef vector<double> vecd;
-    typedef vecev::const_iterator vecev_citer;
-    typedef vecd::const_iterator vecd_citer;
+    return train_windows (
+        sig, bg, init_sig_weights, init_bg_weights, m_quiet, "", status);
+}
+
+void
+VineLearner::start_training () const
+{
+    m_learner->start_training ();
+}
+
+boost::shared_ptr<Model>
+VineLearner::train_quietly (
+    const vector<Event>& sig, const vector<Event>& bg,
+    const vector<double>& init_sig_weights,
+    const vector<double>& init_bg_weights,
+    const string& run,
+    TrainingStatus* status) const
+{
+    return train_windows (
+        sig, bg, init_sig_weights, init_bg_weights, true, run, status);
+}
 
-    // reusable iterators
-    vecev_citer i_ev;
-    vecd_citer i_weight;
+boost::shared_ptr<Model>
+VineLearner::train_windows (
+    const vector<Event>& sig, const vector<Event>& bg,
+    const vector<double>& init_sig_weights,
+    const vector<double>& init_bg_weights,
+    bool quiet, const string& run,
+    TrainingStatus* status) const
+{
+    typedef vector<double> vecd;
 
     // normalize weights
     vecd sig_weights (np::div (init_sig_weights, np::sum (init_sig_weights)));
     vecd bg_weights (np::div (init_bg_weights, np::sum (init_bg_weights)));
 
+    // read the options once, so that changes made while training do not
+    // affect this training
+    const boost::shared_ptr<Learner> learner (m_learner);
+    const int num_threads (m_num_threads);
+    const int window_events (m_window_events);
+    const VineIndex sig_index (sig, m_vine_feature_i);
+    const VineIndex bg_index (bg, m_vine_feature_i);
     vecd bin_mins;
     vecd bin_maxs;
-    vecm models;
-    for (double feature_min (m_vine_feature_min);
-         feature_min + m_vine_feature_width <= m_vine_feature_max;
-         feature_min += m_vine_feature_step) {
-        double feature_max (feature_min + m_vine_feature_width);
-        if (not m_quiet) {
-            cout << "Working on " << feature_min
-                << " <= " << m_vine_feature
-                << " < " << feature_max
-                << "..." << endl;
-        }
-        vecev bin_sig;
-        vecd bin_sig_weights;
-        vecev bin_bg;
-        vecd bin_bg_weights;
-        bin_sig.reserve (sig.size ());
-        bin_sig_weights.reserve (sig.size ());
-        bin_bg.reserve (bg.size ());
-        bin_bg_weights.reserve (bg.size ());
-        for (i_ev = sig.begin (), i_weight = sig_weights.begin ();
-             i_ev != sig.end (); ++i_ev, ++i_weight) {
-            double value (i_ev->value (m_vine_feature_i));
-            if ((feature_min <= value) and (value < feature_max)) {
-                bin_sig.push_back (*i_ev);
-                bin_sig_weights.push_back (*i_weight);
-            }
+    if (window_events > 0) {
+        // keep the overlap of the fixed-width windows
+        const int step_events (max (1, int (
+                    window_events * m_vine_feature_step / m_vine_feature_width
+                    + .5)));
+        quantile_windows (sig_index, bg_index,
+                          m_vine_feature_min, m_vine_feature_max,
+                          window_events, step_events, bin_mins, bin_maxs);
+    }
+    else {
+        for (double feature_min (m_vine_feature_min);
+             feature_min + m_vine_feature_width <= m_vine_feature_max;
+             feature_min += m_vine_feature_step) {
+            bin_mins.push_back (feature_min);
+            bin_maxs.push_back (feature_min + m_vine_feature_width);
         }
-        for (i_ev = bg.begin (), i_weight = bg_weights.begin ();
-             i_ev != bg.end (); ++i_ev, ++i_weight) {
-            double value (i_ev->value (m_vine_feature_i));
-            if ((feature_min <= value) and (value < feature_max)) {
-                bin_bg.push_back (*i_ev);
-                bin_bg_weights.push_back (*i_weight);
-            }
+    }
+    const int n_windows (bin_mins.size ());
+
+    // windows are independent; each writes only its own slot in models,
+    // so the result does not depend on the order in which they finish
+    vector<boost::shared_ptr<Model> > models (n_windows);
+    boost::scoped_ptr<Notifier<int> > notifier;
+    if (not quiet) {
+        notifier.reset (new Notifier<int> (
+                "training vine windows on " + m_vine_feature, n_windows));
+    }
+    WindowTrainer trainer (
+        *learner, sig_index, bg_index, sig, bg, sig_weights, bg_weights,
+        bin_mins, bin_maxs, run, status, notifier.get (), models);
+    try {
+        parallel::parallel_for (n_windows, num_threads, trainer);
+    }
+    catch (const runtime_error&) {
+        // parallel_for reports every failure as a runtime_error
+        if (status and status->cancelled ()) {
+            throw TrainingCancelled ();
         }
-        boost::shared_ptr<Model> bin_model (m_learner->train_given_everything (
-                bin_sig, bin_bg, bin_sig_weights, bin_bg_weights));
-        bin_mins.push_back (feature_min);
-        bin_maxs.push_back (feature_max);
-        models.push_back (bin_model);
+        throw;
+    }
+    if (notifier) {
+        notifier->finish ();
     }
     return boost::make_shared<VineModel> (
         m_feature_names, m_vine_feature, bin_mins, bin_maxs, models);
 }
-
-
-void export_vinelearner ()
-{
-    using namespace boost::python;
-
-    class_<VineLearner, bases<Learner> > (
-        "VineLearner",
-        init<string,double,double,double,double,boost::shared_ptr<Learner> > ())
-        .add_property (
-            "vine_feature",
-            (string (VineLearner::*)()const) &VineLearner::vine_feature,
-            (void (VineLearner::*)(const string&)) &VineLearner::vine_feature)
-        .add_property (
-            "vine_feature_min",
-            (double (VineLearner::*)()const) &VineLearner::vine_feature_min,
-            (void (VineLearner::*)(double)) &VineLearner::vine_feature_min)
-        .add_property (
-            "vine_feature_max",
-            (double (VineLearner::*)()const) &VineLearner::vine_feature_max,
-            (void (VineLearner::*)(double)) &VineLearner::vine_feature_max)
-        .add_property (
-            "vine_feature_width",
-            (double (VineLearner::*)()const) &VineLearner::vine_feature_width,
-            (void (VineLearner::*)(double)) &VineLearner::vine_feature_width)
-        .add_property (
-            "vine_feature_step",
-            (double (VineLearner::*)()const) &VineLearner::vine_feature_step,
-            (void (VineLearner::*)(double)) &VineLearner::vine_feature_step)
-        .add_property (
-            "learner", &VineLearner::learner)
-        ;
-}
@@ -10,14 +10,11 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
 
-#include "boost_python.hpp"
-
 // #include "vinemodel.hpp"
 #include "dataset.hpp"
 #include "learner.hpp"
 
 class VineLearner : public Learner {
-    friend class VineLearner_pickle_suite;
 public:
 
     // structors
@@ -34,6 +31,14 @@ public:
     // inspectors
 
     bool quiet () const;
+    // windows are trained on up to num_threads threads (num_threads <= 0
+    // means one per core); the default is 1
+    int num_threads () const;
+    // if positive, window edges are placed at quantiles of the vine
+    // feature so that each window holds window_events events (sig and bg
+    // together), with the overlap of vine_feature_width and
+    // vine_feature_step; the default 0 keeps fixed-width windows
+    int window_events () const;
     std::string vine_feature () const;
     double vine_feature_min () const;
     double vine_feature_max () const;
@@ -42,6 +47,8 @@ public:
 
     // mutators
     void quiet (bool val);
+    void num_threads (int n);
+    void window_events (int n);
     void vine_feature (const std::string& vine_feature);
     void vine_feature_min (const double vine_feature_min);
     void vine_feature_max (const double vine_feature_max);
@@ -54,11 +61,32 @@ public:
     virtual boost::shared_ptr<Model> train_given_everything (
         const std::vector<Event>& sig, const std::vector<Event>& bg,
         const std::vector<double>& init_sig_weights,
-        const std::vector<double>& init_bg_weights) const;
+        const std::vector<double>& init_bg_weights,
+        TrainingStatus* status=0) const;
+
+    // passed on to learner ()
+    virtual void start_training () const;
+
+    virtual boost::shared_ptr<Model> train_quietly (
+        const std::vector<Event>& sig, const std::vector<Event>& bg,
+        const std::vector<double>& init_sig_weights,
+        const std::vector<double>& init_bg_weights,
+        const std::string& run,
+        TrainingStatus* status=0) const;
 
 
 protected:
 
+    // train every window with learner ()->train_quietly, as run
+    // "<run>/window <i>" (or "window <i>" for an empty run); only the
+    // vine notifier, shown unless quiet, reports progress
+    boost::shared_ptr<Model> train_windows (
+        const std::vector<Event>& sig, const std::vector<Event>& bg,
+        const std::vector<double>& init_sig_weights,
+        const std::vector<double>& init_bg_weights,
+        bool quiet, const std::string& run,
+        TrainingStatus* status) const;
+
     std::string m_vine_feature;
     double m_vine_feature_min;
     double m_vine_feature_max;
@@ -67,14 +95,12 @@ protected:
 
     size_t m_vine_feature_i;
     bool m_quiet;
+    int m_num_threads;
+    int m_window_events;
 
     boost::shared_ptr<Learner> m_learner;
 
 };
 
 
-
-void export_vinelearner ();
-
-
 #endif  /* PYBDT_VINELEARNER_HPP */
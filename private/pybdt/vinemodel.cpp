@@ -1,10 +1,10 @@
-// dtmodel.cpp
-
-#include <Python.h>
+// vinemodel.cpp
 
 #include "vinemodel.hpp"
 #include "np.hpp"
+#include "notifier.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 
@@ -12,8 +12,6 @@
 
 using namespace std;
 using namespace boost;
-using namespace boost::python;
-namespace py = boost::python;
 
 
 VineModel::VineModel (const vector<string>& feature_names,
@@ -31,23 +29,20 @@ VineModel::VineModel (const vector<string>& feature_names,
             break;
         }
     }
-}
-
-VineModel::VineModel (const py::list& feature_names,
-                      const string& vine_feature,
-                      const py::list& bin_mins,
-                      const py::list& bin_maxs,
-                      const py::list& models)
-:   Model (feature_names),
-    m_vine_feature (vine_feature),
-    m_bin_mins (np::list_to_vector<double> (bin_mins)),
-    m_bin_maxs (np::list_to_vector<double> (bin_maxs)),
-    m_models (np::list_to_vector<boost::shared_ptr<Model> > (models))
-{
-    for (size_t i (0); i < m_feature_names.size (); ++i) {
-        if (m_feature_names[i] == m_vine_feature) {
-            m_vine_feature_i = i;
-            break;
+    // split the feature axis at every window edge; each resulting
+    // interval is covered by a fixed set of windows
+    m_edges = m_bin_mins;
+    m_edges.insert (m_edges.end (), m_bin_maxs.begin (), m_bin_maxs.end ());
+    sort (m_edges.begin (), m_edges.end ());
+    m_edges.erase (unique (m_edges.begin (), m_edges.end ()), m_edges.end ());
+    const int n_intervals (max (int (m_edges.size ()) - 1, 0));
+    m_covering.resize (n_intervals);
+    for (int k (0); k < n_intervals; ++k) {
+        for (size_t m (0); m < m_models.size (); ++m) {
+            if (m_bin_mins[m] <= m_edges[k]
+                and m_edges[k + 1] <= m_bin_maxs[m]) {
+                m_covering[k].push_back (m);
+            }
         }
     }
 }
@@ -56,39 +51,113 @@ VineModel::~VineModel ()
 {
 }
 
-double
-VineModel::base_score (const Scoreable& e, bool use_purity) const
+string
+VineModel::vine_feature () const
 {
-    vector<double> scores;
-    scores.reserve (8);
-    for (size_t m (0); m < m_models.size (); ++m) {
-        double bin_min (m_bin_mins[m]);
-        double bin_max (m_bin_maxs[m]);
-        double value (e[m_vine_feature_i]);
-        if ((bin_min <= value) and (value < bin_max)) {
-            scores.push_back (m_models[m]->score (e, use_purity));
-        }
-    }
-    return np::sum (scores) / scores.size ();
+    return m_vine_feature;
 }
 
+vector<double>
+VineModel::bin_mins () const
+{
+    return m_bin_mins;
+}
 
-py::tuple
-VineModel_pickle_suite::getinitargs (const VineModel& m)
+vector<double>
+VineModel::bin_maxs () const
 {
-    return py::make_tuple (
-        np::vector_to_list (m.m_feature_names),
-        m.m_vine_feature,
-        np::vector_to_list (m.m_bin_mins),
-        np::vector_to_list (m.m_bin_maxs),
-        np::vector_to_list (m.m_models));
+    return m_bin_maxs;
 }
 
+vector<boost::shared_ptr<Model> >
+VineModel::models () const
+{
+    return m_models;
+}
 
-void export_vinemodel ()
+int
+VineModel::interval_for_value (double value) const
 {
-    class_<VineModel, bases<Model> > (
-        "VineModel", init<list,string,list,list,list> ())
-        .def_pickle (VineModel_pickle_suite ())
-        ;
+    const int k (upper_bound (m_edges.begin (), m_edges.end (), value)
+                 - m_edges.begin () - 1);
+    return (0 <= k and k < int (m_covering.size ())) ? k : -1;
+}
+
+double
+VineModel::base_score (const Scoreable& e, bool use_purity) const
+{
+    const int k (interval_for_value (e[m_vine_feature_i]));
+    if (k < 0) {
+        return numeric_limits<double>::quiet_NaN ();
+    }
+    const vector<int>& covering (m_covering[k]);
+    double sum (0);
+    for (size_t j (0); j < covering.size (); ++j) {
+        sum += m_models[covering[j]]->score (e, use_purity);
+    }
+    return sum / covering.size ();
+}
+
+vector<double>
+VineModel::base_scores (const vector<Event>& events,
+                        bool use_purity, bool quiet) const
+{
+    const int n_events (events.size ());
+    const int n_intervals (m_covering.size ());
+    const int n_models (m_models.size ());
+
+    // bucket the events by interval
+    vector<vector<int> > in_interval (n_intervals);
+    for (int i (0); i < n_events; ++i) {
+        const int k (interval_for_value (events[i].value (m_vine_feature_i)));
+        if (k >= 0) {
+            in_interval[k].push_back (i);
+        }
+    }
+
+    // each model scores the events of the intervals it covers; visiting
+    // models in order keeps the sum for each event in base_score's order
+    vector<vector<int> > of_model (n_models);
+    for (int k (0); k < n_intervals; ++k) {
+        const vector<int>& covering (m_covering[k]);
+        for (size_t j (0); j < covering.size (); ++j) {
+            vector<int>& block (of_model[covering[j]]);
+            block.insert (block.end (),
+                          in_interval[k].begin (), in_interval[k].end ());
+        }
+    }
+    vector<double> sums (n_events, 0.);
+    vector<int> counts (n_events, 0);
+    Notifier<int> notifier ("scoring vine windows", n_models);
+    if (not quiet) {
+        notifier.update (0);
+    }
+    for (int m (0); m < n_models; ++m) {
+        const vector<int>& block (of_model[m]);
+        vector<Event> block_events;
+        block_events.reserve (block.size ());
+        for (size_t j (0); j < block.size (); ++j) {
+            block_events.push_back (events[block[j]]);
+        }
+        const vector<double> block_scores (
+            m_models[m]->score (block_events, use_purity, true));
+        for (size_t j (0); j < block.size (); ++j) {
+            sums[block[j]] += block_scores[j];
+            ++counts[block[j]];
+        }
+        if (not quiet) {
+            notifier.update (m + 1);
+        }
+    }
+    if (not quiet) {
+        notifier.finish ();
+    }
+
+    vector<double> scores (n_events);
+    for (int i (0); i < n_events; ++i) {
+        scores[i] = (counts[i] and events[i].all_finite ())
+            ? sums[i] / counts[i]
+            : numeric_limits<double>::quiet_NaN ();
+    }
+    return scores;
 }
@@ -8,14 +8,12 @@
 #include <vector>
 #include <utility>
 
-#include "boost_python.hpp"
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include "model.hpp"
 
 class VineModel : public Model {
-    friend class VineModel_pickle_suite;
 public:
 
     // structors
@@ -28,37 +26,39 @@ public:
 
     virtual ~VineModel ();
 
-    // structors for Python
-
-    VineModel (const boost::python::list& feature_names,
-               const std::string& vine_feature,
-               const boost::python::list& bin_mins,
-               const boost::python::list& bin_maxs,
-               const boost::python::list& models);
-
     // inspectors
 
+    std::string vine_feature () const;
+    std::vector<double> bin_mins () const;
+    std::vector<double> bin_maxs () const;
+    std::vector<boost::shared_ptr<Model> > models () const;
+
     std::vector<double> variable_importance (bool sep_weighted) const;
-    boost::python::dict variable_importance_py (bool sep_weighted) const;
 
 protected:
 
     virtual double base_score (const Scoreable& e, bool use_purity) const;
 
+    // groups the events by window, so that each sub-model scores one
+    // contiguous block
+    virtual std::vector<double> base_scores (
+        const std::vector<Event>& events, bool use_purity, bool quiet) const;
+
+    // index of the interval [m_edges[k], m_edges[k+1]) holding value, or
+    // -1 if it is outside all windows
+    int interval_for_value (double value) const;
+
     std::string m_vine_feature;
     size_t m_vine_feature_i;
     std::vector<double> m_bin_mins;
     std::vector<double> m_bin_maxs;
     std::vector<boost::shared_ptr<Model> > m_models;
 
-};
+    // every window edge, sorted; m_covering[k] lists, in order, the models
+    // whose window covers interval k
+    std::vector<double> m_edges;
+    std::vector<std::vector<int> > m_covering;
 
-struct VineModel_pickle_suite : boost::python::pickle_suite {
-    static
-    boost::python::tuple getinitargs (const VineModel& m);
 };
 
-
-void export_vinemodel ();
-
 #endif  /* PYBDT_VINEMODEL_HPP */